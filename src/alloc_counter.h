@@ -0,0 +1,15 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_ALLOC_COUNTER_H
+#define VIEW360_ALLOC_COUNTER_H
+
+// Number of global operator new calls so far. Only counted in debug builds, always 0 otherwise.
+// Allocations made by raylib itself go through malloc and are not counted.
+extern unsigned long long getAllocationCount();
+
+// Resident set size of the process in bytes, 0 when the platform does not report it.
+extern unsigned long long getResidentMemory();
+
+#endif//VIEW360_ALLOC_COUNTER_H
@@ -3,11 +3,21 @@
 //
 
 #include "app.h"
+#include "alloc_counter.h"
+#include "buffer_pool.h"
 #include "config.h"
+#include "gl_ext.h"
+#include "http_source.h"
+#include "image_cache.h"
+#include "image_source.h"
+#include "shader_cache.h"
 #include "shader_source.h"
+#include "shm_feed.h"
 #include "version.h"
+#include <chrono>
 #include <raymath.h>
 #include <rlgl.h>
+#include <sstream>
 
 #if defined(PLATFORM_DESKTOP)
 #define GLSL_VERSION 330
@@ -15,7 +25,53 @@
 #define GLSL_VERSION 100
 #endif
 
-static TextureCubemap genTextureCubemap(const Shader &shader, Texture2D &panorama, int size, int format);
+static bool prepareTextureCubemap(TextureCubemap &cubemap, int size, int format);
+
+static void genTextureCubemap(const Shader &shader, const Texture2D &panorama, TextureCubemap &cubemap, int size, int format);
+
+static Image genPanoramaPreview(const TextureCubemap &cubemap, int width);
+
+struct CubemapLayout {
+    int faceSize;
+    int faceX[6];// face positions in face units, in +X, -X, +Y, -Y, +Z, -Z order
+    int faceY[6];
+};
+
+static bool detectCubemapLayout(int width, int height, CubemapLayout &layout);
+
+static void loadTextureCubemapInPlace(const Image &image, const CubemapLayout &layout, TextureCubemap &cubemap);
+
+// unlike GetTime(), usable before InitWindow()
+static double getClockMs() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char *gPreviewFile = "session_preview.bin";
+static const int gPreviewWidth = 2048;
+static const double gStatsInterval = 0.5;
+static const float gRenderScaleStep = 0.05f;
+static const float gSceneBudgetShare = 0.75f;// of the frame budget, the rest is left for overlays and the driver
+
+static const char *gHelpContents[] = {
+        "Press 'Esc' to EXIT!",
+        "Press 'f' to toggle maximize window.",
+        "Press 'c' to toggle gamma correct.",
+        "Press 'l' to toggle flip image.",
+        "Press 'p' to toggle generate panorama.",
+        "Press 'i' to toggle display information.",
+        "Press 'g' to toggle display grid.",
+        "Press 'r' to toggle dynamic render resolution.",
+        "Press 't' to toggle low latency frame pacing.",
+        "Use Mouse Whell to change camera fovy.",
+        "Use Arrow Left/Right to change window ratio.",
+        "DROP FILE TO OPEN!",
+        "Drop file will clear history.",
+        "You can drop multiple files, or a single directory.",
+        "Zip archives are opened in place, without extraction.",
+        "Paste http urls (Ctrl+V) to stream panoramas.",
+        "Paste shm://<name> to monitor a live feed.",
+        "Use Arrow Up/Down to view in history.",
+};
 
 std::vector<std::array<float, 2>> gRatioList{
         {16, 9},
@@ -28,21 +84,38 @@ std::vector<std::array<float, 2>> gRatioList{
 };
 
 App::App() {
+    _startTime = getClockMs();
     init();
 }
 
 App::~App() {
+    _download.reset();
+    _liveFeed.reset();
     UnloadTexture(_skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture);
-    UnloadShader(_skybox.materials[0].shader);
+    if (IsTextureReady(_panorama)) {
+        UnloadTexture(_panorama);
+    }
+    for (auto &shader: _skyboxShaders) {
+        if (IsShaderReady(shader)) {
+            UnloadShader(shader);
+        }
+    }
     UnloadShader(_renderCubeMapShader);
+    UnloadRenderTexture(_sceneTarget);
+    UnloadRenderTexture(_overlay);
+    _skyboxTimer.unload();
+    _framePacer.unload();
     UnloadModel(_skybox);
     CloseWindow();
 }
 
 void App::run() {
     while (!WindowShouldClose()) {
+        _framePacer.beginFrame();
         update();
     }
+    // main saves the config right after this, before the window and the cubemap are gone
+    saveSession();
 }
 
 void App::init() {
@@ -53,39 +126,44 @@ void App::init() {
     InitWindow(screenWidth, screenHeight, "全景图观察者");
 
     SetTargetFPS(60);
+    _framePacer.setLowLatency(getConfig()->lowLatency);
 
     initScene();
+
+    if (getConfig()->restoreSession) {
+        restoreSession();
+    }
 }
 
 void App::initScene() {
-    const int uniEnvMap = MATERIAL_MAP_CUBEMAP;
     const int uniEquirect = MATERIAL_MAP_ALBEDO;
 
-    int uniDoGamma = getConfig()->gammaCorrect ? 1 : 0;
-    int uniFlipped = getConfig()->flipImage ? 1 : 0;
-
     _camera.position = {1.0f, 1.0f, 1.0f};
     _camera.target = {4.0f, 1.0f, 4.0f};
     _camera.up = {0.0f, 1.0f, 0.0f};
     _camera.fovy = getConfig()->defaultFov;
     _camera.projection = CAMERA_PERSPECTIVE;
+    _currentFovy = getConfig()->defaultFov;
 
     Mesh cube = GenMeshCube(1.0f, 1.0f, 1.0f);
     _skybox = LoadModelFromMesh(cube);
 
-    Shader shaderSkybox = LoadShaderFromMemory(skybox_vs, skybox_fs);
-    SetShaderValue(shaderSkybox, GetShaderLocation(shaderSkybox, "environmentMap"), &uniEnvMap, SHADER_UNIFORM_INT);
-    SetShaderValue(shaderSkybox, GetShaderLocation(shaderSkybox, "doGamma"), &uniDoGamma, SHADER_UNIFORM_INT);
-    SetShaderValue(shaderSkybox, GetShaderLocation(shaderSkybox, "vflipped"), &uniFlipped, SHADER_UNIFORM_INT);
-    _skybox.materials[0].shader = shaderSkybox;
+    useSkyboxShader();
 
-    _renderCubeMapShader = LoadShaderFromMemory(cubemap_vs, cubemap_fs);
+    _renderCubeMapShader = loadShaderCached(cubemap_vs, cubemap_fs);
     SetShaderValue(_renderCubeMapShader, GetShaderLocation(_renderCubeMapShader, "equirectangularMap"), &uniEquirect, SHADER_UNIFORM_INT);
 }
 
 void App::update() {
     handleEvent();
+    updateDownload();
+    updateLiveFeed();
     draw();
+
+    if (_lazyReload && _currentFileIndex >= 0) {
+        loadCubemap();
+        TraceLog(LOG_INFO, "Session: full resolution panorama after %.1f ms", getClockMs() - _startTime);
+    }
 }
 
 void App::handleEvent() {
@@ -136,17 +214,13 @@ void App::handleKeyEvent() {
     }
 
     if (IsKeyPressed(KEY_C)) {
-        Shader &shaderSkybox = _skybox.materials[0].shader;
         getConfig()->gammaCorrect = !getConfig()->gammaCorrect;
-        int uniDoGamma = getConfig()->gammaCorrect ? 1 : 0;
-        SetShaderValue(shaderSkybox, GetShaderLocation(shaderSkybox, "doGamma"), &uniDoGamma, SHADER_UNIFORM_INT);
+        useSkyboxShader();
     }
 
     if (IsKeyPressed(KEY_L)) {
-        Shader &shaderSkybox = _skybox.materials[0].shader;
         getConfig()->flipImage = !getConfig()->flipImage;
-        int uniFlipped = getConfig()->flipImage ? 1 : 0;
-        SetShaderValue(shaderSkybox, GetShaderLocation(shaderSkybox, "vflipped"), &uniFlipped, SHADER_UNIFORM_INT);
+        useSkyboxShader();
     }
 
     if (IsKeyPressed(KEY_P)) {
@@ -171,6 +245,20 @@ void App::handleKeyEvent() {
         getConfig()->showGrid = !getConfig()->showGrid;
     }
 
+    if (IsKeyPressed(KEY_R)) {
+        getConfig()->dynamicResolution = !getConfig()->dynamicResolution;
+    }
+
+    if (IsKeyPressed(KEY_T)) {
+        _framePacer.setLowLatency(!_framePacer.isLowLatency());
+        getConfig()->lowLatency = _framePacer.isLowLatency();
+    }
+
+    bool command = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL) || IsKeyDown(KEY_LEFT_SUPER) || IsKeyDown(KEY_RIGHT_SUPER);
+    if (command && IsKeyPressed(KEY_V)) {
+        handlePasteEvent();
+    }
+
     if (IsKeyDown(KEY_F1) || IsKeyDown(KEY_H)) {
         _showHelp = true;
     }
@@ -228,27 +316,27 @@ void App::handleMouseEvent() {
 void App::handleDropEvent() {
     _fileList.clear();
     _currentFileIndex = -1;
-    const char *filters = ".png;.jpg;.hdr;.bmp;.tga";
+    _download.reset();
+    _liveFeed.reset();
+    _lazyReload = false;// the restored file is replaced, or there is nothing left to load
+    _restoring = false;
+    closeImageSources();
     FilePathList droppedFiles = LoadDroppedFiles();
     if (droppedFiles.count == 1) {
         const char *path = droppedFiles.paths[0];
         if (IsPathFile(path)) {
-            if (IsFileExtension(path, filters)) {
-                _fileList.emplace_back(path);
-            }
+            appendImageSources(path, _fileList);
         } else {
-            auto subFiles = LoadDirectoryFilesEx(path, filters, false);
+            auto subFiles = LoadDirectoryFilesEx(path, nullptr, false);
             for (unsigned int i = 0; i < subFiles.count; ++i) {
-                _fileList.emplace_back(subFiles.paths[i]);
+                appendImageSources(subFiles.paths[i], _fileList);
             }
             UnloadDirectoryFiles(subFiles);
         }
 
     } else if (droppedFiles.count > 1) {
         for (unsigned int i = 0; i < droppedFiles.count; ++i) {
-            if (IsFileExtension(droppedFiles.paths[i], filters)) {
-                _fileList.emplace_back(droppedFiles.paths[i]);
-            }
+            appendImageSources(droppedFiles.paths[i], _fileList);
         }
     }
     if (!_fileList.empty()) {
@@ -258,17 +346,143 @@ void App::handleDropEvent() {
     UnloadDroppedFiles(droppedFiles);
 }
 
+// one url or path per line, replaces the history like a drop does
+void App::handlePasteEvent() {
+    const char *text = GetClipboardText();
+    if (!text || !*text) {
+        return;
+    }
+
+    _fileList.clear();
+    _currentFileIndex = -1;
+    _download.reset();
+    _liveFeed.reset();
+    _lazyReload = false;
+    _restoring = false;
+    closeImageSources();
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);) {
+        size_t first = line.find_first_not_of(" \t\r");
+        size_t last = line.find_last_not_of(" \t\r");
+        if (first != std::string::npos) {
+            appendImageSources(line.substr(first, last - first + 1).c_str(), _fileList);
+        }
+    }
+    if (!_fileList.empty()) {
+        _currentFileIndex = 0;
+        _reload = true;
+    }
+}
+
+void App::updateDownload() {
+    if (!_download) {
+        return;
+    }
+
+    // read before taking the image, so the final one is never missed
+    bool finished = _download->isFinished();
+    Image img = {0};
+    bool complete = false;
+    if (_download->takeImage(img, complete)) {
+        loadCubemapFromImage(img);
+        UnloadImage(img);
+        if (complete) {
+            logMemory(_download->url());
+        }
+    }
+    if (finished) {
+        _download.reset();
+    }
+}
+
+// at most one frame per draw, the feed skips whatever arrived in between
+void App::updateLiveFeed() {
+    if (!_liveFeed || !_liveFeed->update(_panorama)) {
+        return;
+    }
+    genTextureCubemap(_renderCubeMapShader, _panorama, _skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture, _textureSize, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    _liveFramePending = true;
+}
+
 void App::draw() {
+#ifdef _DEBUG
+    unsigned long long allocations = getAllocationCount();
+#endif
+
+    updateRenderScale();
+
     BeginDrawing();
     ClearBackground(RAYWHITE);
 
+    int renderWidth = GetRenderWidth();
+    int renderHeight = GetRenderHeight();
+    if (_renderScale < 1.0f && renderWidth > 0 && renderHeight > 0) {
+        if (!IsRenderTextureReady(_sceneTarget) || _sceneTarget.texture.width != renderWidth || _sceneTarget.texture.height != renderHeight) {
+            UnloadRenderTexture(_sceneTarget);
+            _sceneTarget = LoadRenderTexture(renderWidth, renderHeight);
+            SetTextureFilter(_sceneTarget.texture, TEXTURE_FILTER_BILINEAR);
+        }
+
+        // draw into the bottom-left corner of a full size target, so scale changes never reallocate it
+        int sceneWidth = std::max(1, (int) ((float) renderWidth * _renderScale));
+        int sceneHeight = std::max(1, (int) ((float) renderHeight * _renderScale));
+        BeginTextureMode(_sceneTarget);
+        ClearBackground(RAYWHITE);
+        rlViewport(0, 0, sceneWidth, sceneHeight);
+        drawScene();
+        EndTextureMode();
+
+        Rectangle source = {0.0f, 0.0f, (float) sceneWidth, (float) -sceneHeight};
+        Rectangle dest = {0.0f, 0.0f, (float) GetScreenWidth(), (float) GetScreenHeight()};
+        DrawTexturePro(_sceneTarget.texture, source, dest, {0.0f, 0.0f}, 0.0f, WHITE);
+    } else {
+        drawScene();
+    }
+
+    drawOverlay();
+
+    _framePacer.beforePresent(_skyboxTimer.lastMs());
+    EndDrawing();
+    _framePacer.endFrame();
+
+    if (_liveFramePending && _liveFeed && _liveFeed->frameTimestampNs() != 0) {
+        auto nowNs = (unsigned long long) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        float latencyMs = (float) ((double) (nowNs - _liveFeed->frameTimestampNs()) * 1e-6);
+        _liveLatencyMs = _liveLatencyMs < 0.0f ? latencyMs : _liveLatencyMs * 0.9f + latencyMs * 0.1f;
+    }
+    _liveFramePending = false;
+
+#ifdef _DEBUG
+    // the draw path is expected to be allocation free
+    unsigned long long frameAllocations = getAllocationCount() - allocations;
+    if (frameAllocations != _frameAllocations) {
+        _frameAllocations = frameAllocations;
+        TraceLog(frameAllocations ? LOG_WARNING : LOG_INFO, "Draw: %llu allocations per frame", frameAllocations);
+    }
+#endif
+
+    if (_startupMs < 0.0f) {
+        _startupMs = (float) (getClockMs() - _startTime);
+        TraceLog(LOG_INFO, "Startup: first frame presented after %.1f ms", _startupMs);
+    }
+
+    if (_restoring && IsTextureReady(_skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture)) {
+        _restoreMs = (float) (getClockMs() - _startTime);
+        TraceLog(LOG_INFO, "Session: first panorama after %.1f ms (%s)", _restoreMs, _restoredFromPreview ? "warm, cached preview" : "cold, full decode");
+        _restoring = false;
+    }
+}
+
+void App::drawScene() {
     _camera.fovy = _currentFovy;
     BeginMode3D(_camera);
 
-    if (_currentFileIndex >= 0) {
+    if (_currentFileIndex >= 0 && IsTextureReady(_skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture)) {
         rlDisableBackfaceCulling();
         rlDisableDepthMask();
+        _skyboxTimer.begin();
         DrawModel(_skybox, {0.0f, 0.0f, 0.0f}, 1.0f, WHITE);
+        _skyboxTimer.end();
         rlEnableBackfaceCulling();
         rlEnableDepthMask();
     }
@@ -277,18 +491,35 @@ void App::draw() {
         DrawGrid(10, 1.0f);
     }
     EndMode3D();
+}
 
-    drawHelpTips();
-
-    if (getConfig()->showInfo) {
-        drawInfo();
+void App::updateRenderScale() {
+    const Config *config = getConfig();
+    if (!config->dynamicResolution) {
+        _renderScale = 1.0f;
+        _renderScaleSmoothed = 1.0f;
+        return;
     }
 
-    if (_showHelp) {
-        drawHelp();
+    float minScale = Clamp(config->minRenderScale, 0.1f, 1.0f);
+    float target = _renderScaleSmoothed;
+    if (_skyboxTimer.isSupported()) {
+        // the skybox cost is per pixel, so it scales with the square of the render scale
+        float costMs = _skyboxTimer.lastMs();
+        if (costMs > 0.0f) {
+            target = _renderScale * sqrtf(config->frameBudgetMs * gSceneBudgetShare / costMs);
+        }
+    } else {
+        // vsync hides any headroom in the frame time, so probe upwards slowly
+        float frameMs = GetFrameTime() * 1000.0f;
+        target = frameMs > config->frameBudgetMs * 1.2f ? _renderScale * 0.9f : _renderScale * 1.02f;
     }
+    target = Clamp(target, minScale, 1.0f);
 
-    EndDrawing();
+    // smooth, then snap to steps so the scale does not change on every frame
+    _renderScaleSmoothed = Lerp(_renderScaleSmoothed, target, 0.1f);
+    float stepped = roundf(_renderScaleSmoothed / gRenderScaleStep) * gRenderScaleStep;
+    _renderScale = Clamp(stepped, minScale, 1.0f);
 }
 
 void App::drawHelp() {
@@ -308,29 +539,16 @@ void App::drawHelp() {
     const char *compile_mode = "RELEASE";
 #endif
 
-    std::vector<std::string> contents;
-    contents.emplace_back("Press 'Esc' to EXIT!");
-    contents.emplace_back("Press 'f' to toggle maximize window.");
-    contents.emplace_back("Press 'c' to toggle gamma correct.");
-    contents.emplace_back("Press 'l' to toggle flip image.");
-    contents.emplace_back("Press 'p' to toggle generate panorama.");
-    contents.emplace_back("Press 'i' to toggle display information.");
-    contents.emplace_back("Press 'g' to toggle display grid.");
-    contents.emplace_back("Use Mouse Whell to change camera fovy.");
-    contents.emplace_back("Use Arrow Left/Right to change window ratio.");
-    contents.emplace_back("DROP FILE TO OPEN!");
-    contents.emplace_back("Drop file will clear history.");
-    contents.emplace_back("You can drop multiple files, or a single directory.");
-    contents.emplace_back("Use Arrow Up/Down to view in history.");
-    contents.emplace_back(TextFormat("[%s] [%s] [%s %s]", VERSION_STRING, compile_mode, __DATE__, __TIME__));
-
-    int maxWidth = 0;
-    for (const auto &content: contents) {
-        maxWidth = std::max(maxWidth, MeasureText(content.c_str(), fontSize));
+    const char *version = TextFormat("[%s] [%s] [%s %s]", VERSION_STRING, compile_mode, __DATE__, __TIME__);
+    const int lineCount = (int) (sizeof(gHelpContents) / sizeof(gHelpContents[0])) + 1;
+
+    int maxWidth = MeasureText(version, fontSize);
+    for (const char *content: gHelpContents) {
+        maxWidth = std::max(maxWidth, MeasureText(content, fontSize));
     }
 
     int rectWidth = maxWidth + 2 * margin;
-    int rectHeight = (int) contents.size() * (fontSize + spacing) + 2 * margin - spacing;
+    int rectHeight = lineCount * (fontSize + spacing) + 2 * margin - spacing;
 
     int posX = (w - rectWidth) / 2;
     int posY = (h - rectHeight) / 2;
@@ -339,16 +557,13 @@ void App::drawHelp() {
 
     posX += margin;
     posY += margin;
-    for (const auto &content: contents) {
-        Color color = textColor;
-        if (content.back() == '!') {
-            color = textColorHighlight;
-        } else if (content.back() == ']') {
-            color = textColorHighlight2;
-        }
-        DrawText(content.c_str(), posX, posY, fontSize, color);
+    for (const char *content: gHelpContents) {
+        unsigned int length = TextLength(content);
+        Color color = (length > 0 && content[length - 1] == '!') ? textColorHighlight : textColor;
+        DrawText(content, posX, posY, fontSize, color);
         posY += fontSize + spacing;
     }
+    DrawText(version, posX, posY, fontSize, textColorHighlight2);
 }
 
 void App::drawInfo() {
@@ -383,9 +598,55 @@ void App::drawInfo() {
     DrawText(TextFormat("%g : %g", gRatioList[_ratioIndex][0], gRatioList[_ratioIndex][1]), posX2, posY, fontSize, textColorHighlight);
     posY += posYOffset;
 
+    DrawText("[R]ender Scale:", posX1, posY, fontSize, textColor);
+    DrawText(TextFormat("%s%.0f%%", getConfig()->dynamicResolution ? "Auto " : "", _renderScale * 100.0f), posX2, posY, fontSize, textColorHighlight);
+    posY += posYOffset;
+
+    if (_downloadProgress >= 0.0f) {
+        DrawText("Download:", posX1, posY, fontSize, textColor);
+        DrawText(TextFormat("%.0f%%", _downloadProgress * 100.0f), posX2, posY, fontSize, textColorHighlight);
+        posY += posYOffset;
+    }
+
+    if (_liveFeed) {
+        DrawText("Live Feed:", posX1, posY, fontSize, textColor);
+        DrawText(_liveFps < 0.0f ? "Waiting" : TextFormat("%.0f fps, %.1f ms, %llu dropped", _liveFps, _liveLatencySampleMs, _liveDropped), posX2, posY, fontSize, textColorHighlight);
+        posY += posYOffset;
+    }
+
     DrawText("Camera Fovy:", posX1, posY, fontSize, textColor);
     DrawText(TextFormat("%g", _currentFovy), posX2, posY, fontSize, textColorHighlight);
     posY += posYOffset;
+
+    DrawText("Low La[t]ency:", posX1, posY, fontSize, textColor);
+    DrawText(_framePacer.isLowLatency() ? "On" : "Off", posX2, posY, fontSize, textColorHighlight);
+    posY += posYOffset;
+
+    DrawText("Input Latency:", posX1, posY, fontSize, textColor);
+    DrawText(_latencyMs < 0.0f ? "N/A" : TextFormat("%.1f ms", _latencyMs), posX2, posY, fontSize, textColorHighlight);
+    posY += posYOffset;
+
+    DrawText("Skybox GPU:", posX1, posY, fontSize, textColor);
+    DrawText(_skyboxMs < 0.0f ? "N/A" : TextFormat("%.2f ms", _skyboxMs), posX2, posY, fontSize, textColorHighlight);
+    posY += posYOffset;
+
+    DrawText("Memory:", posX1, posY, fontSize, textColor);
+    DrawText(_residentMemory == 0 ? "N/A" : TextFormat("%.0f MB", (double) _residentMemory / (1024.0 * 1024.0)), posX2, posY, fontSize, textColorHighlight);
+    posY += posYOffset;
+
+    DrawText("Buffers:", posX1, posY, fontSize, textColor);
+    DrawText(TextFormat("%.0f MB idle, %llu reused / %llu allocated", (double) _bufferStats.bytesIdle / (1024.0 * 1024.0), _bufferStats.reuses, _bufferStats.allocations), posX2, posY, fontSize, textColorHighlight);
+    posY += posYOffset;
+
+    DrawText("Startup:", posX1, posY, fontSize, textColor);
+    DrawText(_startupMs < 0.0f ? "N/A" : TextFormat("%.0f ms", _startupMs), posX2, posY, fontSize, textColorHighlight);
+    posY += posYOffset;
+
+    if (_restoreMs >= 0.0f) {
+        DrawText("Restore:", posX1, posY, fontSize, textColor);
+        DrawText(TextFormat("%.0f ms (%s)", _restoreMs, _restoredFromPreview ? "warm" : "cold"), posX2, posY, fontSize, textColorHighlight);
+        posY += posYOffset;
+    }
 }
 
 void App::drawHelpTips() {
@@ -406,33 +667,333 @@ void App::drawHelpTips() {
     }
 }
 
+void App::drawOverlay() {
+    int w = GetScreenWidth();
+    int h = GetScreenHeight();
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+
+    if (GetTime() - _statsTime >= gStatsInterval) {
+        double previousTime = _statsTime;
+        _statsTime = GetTime();
+        _skyboxMs = _skyboxTimer.lastMs();
+        _latencyMs = _framePacer.latencyMs();
+        _downloadProgress = _download ? _download->progress() : -1.0f;
+        _bufferStats = getBufferPoolStats();
+        _residentMemory = getResidentMemory();
+        if (_liveFeed) {
+            unsigned long long shown = _liveFeed->framesShown();
+            _liveFps = _liveFeed->isAttached() ? (float) ((double) (shown - _liveShownAtSample) / (GetTime() - previousTime)) : -1.0f;
+            _liveShownAtSample = shown;
+            _liveDropped = _liveFeed->framesDropped();
+            _liveLatencySampleMs = _liveFps > 0.0f ? _liveLatencyMs : -1.0f;
+        }
+    }
+
+    bool resized = false;
+    if (!IsRenderTextureReady(_overlay) || _overlay.texture.width != w || _overlay.texture.height != h) {
+        UnloadRenderTexture(_overlay);
+        _overlay = LoadRenderTexture(w, h);
+        resized = true;
+    }
+
+    unsigned long long key = overlayKey();
+    if (resized || key != _overlayKey) {
+        _overlayKey = key;
+
+        BeginTextureMode(_overlay);
+        ClearBackground(BLANK);
+
+        drawHelpTips();
+
+        if (getConfig()->showInfo) {
+            drawInfo();
+        }
+
+        if (_showHelp) {
+            drawHelp();
+        }
+
+        EndTextureMode();
+    }
+
+    // render textures are stored bottom-up
+    DrawTextureRec(_overlay.texture, {0.0f, 0.0f, (float) w, (float) -h}, {0.0f, 0.0f}, WHITE);
+}
+
+static unsigned long long hashBytes(unsigned long long hash, const void *data, size_t size) {
+    const auto *bytes = (const unsigned char *) data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+template<typename T>
+static unsigned long long hashValue(unsigned long long hash, const T &value) {
+    return hashBytes(hash, &value, sizeof(value));
+}
+
+// everything drawn by drawInfo, drawHelp and drawHelpTips must be part of the key
+unsigned long long App::overlayKey() const {
+    const Config *config = getConfig();
+    int fontSize = config->fontSize;
+    int tipsPosY = GetScreenHeight() - 10 - fontSize;
+    bool tipsHovered = CheckCollisionPointRec(GetMousePosition(), {10.0f, (float) tipsPosY, 15.0f, 15.0f});
+
+    unsigned long long hash = 14695981039346656037ull;
+    hash = hashValue(hash, fontSize);
+    hash = hashValue(hash, tipsHovered);
+    hash = hashValue(hash, _showHelp);
+    hash = hashValue(hash, config->showInfo);
+    if (!config->showInfo) {
+        return hash;
+    }
+
+    if (_currentFileIndex >= 0) {
+        const std::string &filename = _fileList[_currentFileIndex];
+        hash = hashBytes(hash, filename.data(), filename.size());
+    }
+    hash = hashValue(hash, config->gammaCorrect);
+    hash = hashValue(hash, config->flipImage);
+    hash = hashValue(hash, config->needGenCubeMap);
+    hash = hashValue(hash, _ratioIndex);
+    hash = hashValue(hash, _currentFovy);
+    hash = hashValue(hash, config->dynamicResolution);
+    hash = hashValue(hash, _renderScale);
+    hash = hashValue(hash, _skyboxMs);
+    hash = hashValue(hash, _framePacer.isLowLatency());
+    hash = hashValue(hash, _latencyMs);
+    hash = hashValue(hash, _downloadProgress);
+    hash = hashValue(hash, _liveFeed != nullptr);
+    hash = hashValue(hash, _liveFps);
+    hash = hashValue(hash, _liveLatencySampleMs);
+    hash = hashValue(hash, _liveDropped);
+    hash = hashValue(hash, _residentMemory >> 20);// shown in MB
+    hash = hashValue(hash, _bufferStats.bytesIdle);
+    hash = hashValue(hash, _bufferStats.reuses);
+    hash = hashValue(hash, _bufferStats.allocations);
+    hash = hashValue(hash, _startupMs);
+    hash = hashValue(hash, _restoreMs);
+    return hash;
+}
+
 void App::loadCubemap() {
-    if (IsTextureReady(_skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture)) {
-        UnloadTexture(_skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture);
-    }
-    const char *filePath = _fileList[_currentFileIndex].c_str();
-    if (filePath) {
-        Image img = LoadImage(filePath);
-        if (getConfig()->needGenCubeMap) {
-            Texture2D panorama = LoadTextureFromImage(img);
-            _skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture = genTextureCubemap(_renderCubeMapShader, panorama, _textureSize, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
-            UnloadTexture(panorama);
-        } else {
-            _skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture = LoadTextureCubemap(img, CUBEMAP_LAYOUT_AUTO_DETECT);
+    _lazyReload = false;
+
+    _download.reset();
+    _liveFeed.reset();
+
+    if (_currentFileIndex < 0 || _currentFileIndex >= (int) _fileList.size()) {
+        return;// e.g. a texture size key before anything was opened
+    }
+
+    // the current cubemap is only dropped when nothing replaces it, otherwise it is reused
+    const std::string &filePath = _fileList[_currentFileIndex];
+    if (filePath.empty()) {
+        unloadCubemap();
+        return;
+    }
+
+    if (isShmSource(filePath)) {
+        // frames are uploaded by updateLiveFeed() as they arrive
+        unloadCubemap();
+        _liveFeed = std::make_unique<ShmFeed>(filePath);
+        _liveFps = -1.0f;
+        _liveLatencyMs = -1.0f;
+        _liveLatencySampleMs = -1.0f;
+        _liveDropped = 0;
+        _liveShownAtSample = 0;
+        return;
+    }
+
+    if (isHttpSource(filePath) && !FileExists(getHttpCachePath(filePath).c_str())) {
+        // shown by updateDownload() while it arrives
+        unloadCubemap();
+        _download = std::make_unique<HttpDownload>(filePath);
+        return;
+    }
+
+    CubemapLayout layout{};
+    int width = 0;
+    int height = 0;
+    if (!getConfig()->needGenCubeMap && readImageSize(filePath, width, height) && !detectCubemapLayout(width, height, layout)) {
+        // no need to decode what cannot be shown
+        TraceLog(LOG_WARNING, "CUBEMAP: [%s] %dx%d is not a cross, strip or 3x2 layout", filePath.c_str(), width, height);
+        unloadCubemap();
+        return;
+    }
+
+    Image img = loadImageFromSource(filePath);
+    if (!IsImageReady(img)) {
+        unloadCubemap();
+        return;
+    }
+    loadCubemapFromImage(img);
+    UnloadImage(img);
+    logMemory(filePath);
+}
+
+// replaces the current cubemap, progressive downloads call this once per refinement
+void App::loadCubemapFromImage(const Image &img) {
+    Texture2D &cubemap = _skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture;
+    CubemapLayout layout{};
+    if (getConfig()->needGenCubeMap) {
+        uploadPanorama(img);
+        genTextureCubemap(_renderCubeMapShader, _panorama, cubemap, _textureSize, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    } else if (detectCubemapLayout(img.width, img.height, layout)) {
+        loadTextureCubemapInPlace(img, layout, cubemap);
+    } else {
+        unloadCubemap();
+        cubemap = LoadTextureCubemap(img, CUBEMAP_LAYOUT_AUTO_DETECT);
+    }
+}
+
+// kept between loads and updated in place while the size and format stay the same
+void App::uploadPanorama(const Image &img) {
+    if (IsTextureReady(_panorama) && _panorama.width == img.width && _panorama.height == img.height && _panorama.format == img.format && img.mipmaps == 1) {
+        UpdateTexture(_panorama, img.data);
+        return;
+    }
+    if (IsTextureReady(_panorama)) {
+        UnloadTexture(_panorama);
+    }
+    _panorama = LoadTextureFromImage(img);
+}
+
+void App::unloadCubemap() {
+    Texture2D &cubemap = _skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture;
+    if (IsTextureReady(cubemap)) {
+        UnloadTexture(cubemap);
+        cubemap = {0};
+    }
+}
+
+void App::logMemory(const std::string &filePath) const {
+    BufferPoolStats stats = getBufferPoolStats();
+    TraceLog(LOG_INFO, "Memory: [%s] %.1f MB resident, buffers %llu allocated / %llu reused, %.1f MB idle", filePath.c_str(),
+             (double) getResidentMemory() / (1024.0 * 1024.0), stats.allocations, stats.reuses, (double) stats.bytesIdle / (1024.0 * 1024.0));
+}
+
+void App::useSkyboxShader() {
+    bool flipped = getConfig()->flipImage;
+    bool doGamma = getConfig()->gammaCorrect;
+    int variant = (flipped ? 1 : 0) | (doGamma ? 2 : 0);
+
+    Shader &shader = _skyboxShaders[variant];
+    if (!IsShaderReady(shader)) {
+        const int uniEnvMap = MATERIAL_MAP_CUBEMAP;
+
+        double start = getClockMs();
+        std::string fs = skyboxFragmentShader(flipped, doGamma);
+        shader = loadShaderCached(skybox_vs, fs.c_str());
+        SetShaderValue(shader, GetShaderLocation(shader, "environmentMap"), &uniEnvMap, SHADER_UNIFORM_INT);
+        TraceLog(LOG_INFO, "Skybox shader variant %d ready in %.2f ms", variant, getClockMs() - start);
+    }
+    _skybox.materials[0].shader = shader;
+}
+
+void App::restoreSession() {
+    const Session *session = getSession();
+
+    _camera.position = {session->cameraPosition[0], session->cameraPosition[1], session->cameraPosition[2]};
+    _camera.target = {session->cameraTarget[0], session->cameraTarget[1], session->cameraTarget[2]};
+    if (session->fovy > 0.0f) {
+        _currentFovy = Clamp(session->fovy, getConfig()->minFov, getConfig()->maxFov);
+    }
+    for (int size: {1024, 2048, 4096, 8192}) {
+        if (session->textureSize == size) {
+            _textureSize = size;
+        }
+    }
+
+    // files may have been moved or deleted since the last run
+    std::string currentFile;
+    if (session->currentFileIndex >= 0 && session->currentFileIndex < (int) session->fileList.size()) {
+        currentFile = session->fileList[session->currentFileIndex];
+    }
+    for (const auto &file: session->fileList) {
+        if (isImageSourceAvailable(file)) {
+            if (file == currentFile) {
+                _currentFileIndex = (int) _fileList.size();
+            }
+            _fileList.push_back(file);
+        }
+    }
+    if (_fileList.empty()) {
+        return;
+    }
+    if (_currentFileIndex < 0) {
+        _currentFileIndex = 0;
+    }
+
+    // the full resolution decode runs after the first frame is on screen
+    _restoring = true;
+    _lazyReload = true;
+
+    if (session->previewFile == _fileList[_currentFileIndex]) {
+        Image preview = loadImageRaw(getConfigDir() + gPreviewFile);
+        if (preview.data) {
+            uploadPanorama(preview);
+            genTextureCubemap(_renderCubeMapShader, _panorama, _skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture, preview.height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            UnloadImage(preview);
+            _restoredFromPreview = true;
         }
-        UnloadImage(img);
     }
 }
 
-static TextureCubemap genTextureCubemap(const Shader &shader, Texture2D &panorama, int size, int format) {
-    TextureCubemap cubemap = {0};
+void App::saveSession() {
+    Session *session = getSession();
+    session->fileList = _fileList;
+    session->currentFileIndex = _currentFileIndex;
+    session->textureSize = _textureSize;
+    session->cameraPosition = {_camera.position.x, _camera.position.y, _camera.position.z};
+    session->cameraTarget = {_camera.target.x, _camera.target.y, _camera.target.z};
+    session->fovy = _currentFovy;
+    session->previewFile.clear();
+
+    const TextureCubemap &cubemap = _skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture;
+    if (getConfig()->restoreSession && _currentFileIndex >= 0 && IsTextureReady(cubemap)) {
+        Image preview = genPanoramaPreview(cubemap, gPreviewWidth);
+        if (saveImageRaw(getConfigDir() + gPreviewFile, preview)) {
+            session->previewFile = _fileList[_currentFileIndex];
+        }
+        UnloadImage(preview);
+    }
+}
+
+// keeps `cubemap` when its size and format already match, callers overwrite all six faces
+static bool prepareTextureCubemap(TextureCubemap &cubemap, int size, int format) {
+    if (IsTextureReady(cubemap) && cubemap.width == size && cubemap.format == format && cubemap.mipmaps == 1) {
+        return true;
+    }
+    if (IsTextureReady(cubemap)) {
+        UnloadTexture(cubemap);
+    }
+    cubemap = {0};
+    cubemap.id = rlLoadTextureCubemap(nullptr, size, format);
+    if (cubemap.id == 0) {
+        return false;
+    }
+    cubemap.width = size;
+    cubemap.height = size;
+    cubemap.mipmaps = 1;
+    cubemap.format = format;
+    return true;
+}
+
+static void genTextureCubemap(const Shader &shader, const Texture2D &panorama, TextureCubemap &cubemap, int size, int format) {
+    if (!prepareTextureCubemap(cubemap, size, format)) {
+        return;
+    }
 
     rlDisableBackfaceCulling();
 
     // step 1: setup framebuffer
     //---------------------------------------------------------------------------------
     unsigned int rbo = rlLoadTextureDepth(size, size, true);
-    cubemap.id = rlLoadTextureCubemap(nullptr, size, format);
 
     unsigned int fbo = rlLoadFramebuffer(size, size);
     rlFramebufferAttach(fbo, rbo, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
@@ -480,11 +1041,111 @@ static TextureCubemap genTextureCubemap(const Shader &shader, Texture2D &panoram
 
     rlViewport(0, 0, GetScreenWidth(), GetScreenHeight());
     rlEnableBackfaceCulling();
+}
 
-    cubemap.width = size;
-    cubemap.height = size;
-    cubemap.mipmaps = 1;
-    cubemap.format = format;
+// renders the cubemap back to a small equirectangular image, which genTextureCubemap can turn into the same cubemap
+static Image genPanoramaPreview(const TextureCubemap &cubemap, int width) {
+    const int uniEnvMap = 0;
+    Shader shader = loadShaderCached(equirect_vs, equirect_fs);
+    SetShaderValue(shader, GetShaderLocation(shader, "environmentMap"), &uniEnvMap, SHADER_UNIFORM_INT);
+
+    RenderTexture2D target = LoadRenderTexture(width, width / 2);
+
+    rlDisableBackfaceCulling();
+    rlEnableFramebuffer(target.id);
+    rlViewport(0, 0, width, width / 2);
+    rlClearScreenBuffers();
 
-    return cubemap;
+    rlEnableShader(shader.id);
+    rlActiveTextureSlot(0);
+    rlEnableTextureCubemap(cubemap.id);
+    rlLoadDrawQuad();
+
+    rlDisableTextureCubemap();
+    rlDisableShader();
+    rlDisableFramebuffer();
+    rlViewport(0, 0, GetScreenWidth(), GetScreenHeight());
+    rlEnableBackfaceCulling();
+
+    Image preview = LoadImageFromTexture(target.texture);
+    UnloadRenderTexture(target);
+    UnloadShader(shader);
+    return preview;
+}
+
+// same layouts and face placement as LoadTextureCubemap, plus 3x2 (+X -X +Y / -Y +Z -Z)
+static bool detectCubemapLayout(int width, int height, CubemapLayout &layout) {
+    static const CubemapLayout lineHorizontal = {0, {0, 1, 2, 3, 4, 5}, {0, 0, 0, 0, 0, 0}};
+    static const CubemapLayout lineVertical = {0, {0, 0, 0, 0, 0, 0}, {0, 1, 2, 3, 4, 5}};
+    static const CubemapLayout crossThreeByFour = {0, {1, 1, 1, 1, 0, 2}, {1, 3, 0, 2, 1, 1}};
+    static const CubemapLayout crossFourByThree = {0, {2, 0, 1, 1, 1, 3}, {1, 1, 0, 2, 1, 1}};
+    static const CubemapLayout threeByTwo = {0, {0, 1, 2, 0, 1, 2}, {0, 0, 0, 1, 1, 1}};
+
+    // same quotient tests as raylib's CUBEMAP_LAYOUT_AUTO_DETECT, so images a few pixels off still load,
+    // extra pixels on the right and bottom are ignored
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    if (width > height && width / 6 == height) {
+        layout = lineHorizontal;
+        layout.faceSize = width / 6;
+    } else if (width > height && width / 4 == height / 3) {
+        layout = crossFourByThree;
+        layout.faceSize = width / 4;
+    } else if (height > width && height / 6 == width) {
+        layout = lineVertical;
+        layout.faceSize = height / 6;
+    } else if (height > width && width / 3 == height / 4) {
+        layout = crossThreeByFour;
+        layout.faceSize = width / 3;
+    } else if (width > height && width / 3 == height / 2) {
+        layout = threeByTwo;
+        layout.faceSize = width / 3;
+    } else {
+        return false;
+    }
+    if (layout.faceSize <= 0) {
+        return false;
+    }
+    return true;
+}
+
+// Uploads every face straight out of the source image with the unpack row length/skip parameters,
+// instead of copying the faces into a new image first like LoadTextureCubemap does.
+static void loadTextureCubemapInPlace(const Image &image, const CubemapLayout &layout, TextureCubemap &cubemap) {
+    const GLExt *gl = getGLExt();
+    if (!gl->BindTexture || !gl->PixelStorei || !gl->TexSubImage2D || !gl->GetIntegerv || image.format >= PIXELFORMAT_COMPRESSED_DXT1_RGB) {
+        if (IsTextureReady(cubemap)) {
+            UnloadTexture(cubemap);
+        }
+        cubemap = LoadTextureCubemap(image, CUBEMAP_LAYOUT_AUTO_DETECT);
+        return;
+    }
+
+    int size = layout.faceSize;
+    if (!prepareTextureCubemap(cubemap, size, image.format)) {
+        return;
+    }
+
+    unsigned int glInternalFormat = 0;
+    unsigned int glFormat = 0;
+    unsigned int glType = 0;
+    rlGetGlTextureFormats(image.format, &glInternalFormat, &glFormat, &glType);
+
+    int alignment = 4;
+    gl->GetIntegerv(VIEW360_GL_UNPACK_ALIGNMENT, &alignment);
+
+    gl->BindTexture(VIEW360_GL_TEXTURE_CUBE_MAP, cubemap.id);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ALIGNMENT, 1);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ROW_LENGTH, image.width);
+    for (int i = 0; i < 6; i++) {
+        gl->PixelStorei(VIEW360_GL_UNPACK_SKIP_PIXELS, layout.faceX[i] * size);
+        gl->PixelStorei(VIEW360_GL_UNPACK_SKIP_ROWS, layout.faceY[i] * size);
+        gl->TexSubImage2D(VIEW360_GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, 0, 0, size, size, glFormat, glType, image.data);
+    }
+    gl->PixelStorei(VIEW360_GL_UNPACK_SKIP_ROWS, 0);
+    gl->PixelStorei(VIEW360_GL_UNPACK_SKIP_PIXELS, 0);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ROW_LENGTH, 0);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ALIGNMENT, alignment);
+    gl->BindTexture(VIEW360_GL_TEXTURE_CUBE_MAP, 0);
 }
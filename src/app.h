@@ -5,11 +5,19 @@
 #ifndef VIEW360_APP_H
 #define VIEW360_APP_H
 
+#include "buffer_pool.h"
+#include "frame_pacer.h"
+#include "gpu_timer.h"
 #include <array>
+#include <memory>
 #include <raylib.h>
 #include <string>
 #include <vector>
 
+class HttpDownload;
+
+class ShmFeed;
+
 class App {
 public:
     App();
@@ -33,19 +41,70 @@ private:
 
     void handleDropEvent();
 
+    void handlePasteEvent();
+
+    void updateDownload();
+
+    void updateLiveFeed();
+
     void draw();
 
+    void drawScene();
+
+    void updateRenderScale();
+
     void drawHelp();
 
     void drawInfo();
 
     void drawHelpTips();
 
+    void drawOverlay();
+
+    unsigned long long overlayKey() const;
+
     void loadCubemap();
 
+    void loadCubemapFromImage(const Image &img);
+
+    void uploadPanorama(const Image &img);
+
+    void unloadCubemap();
+
+    void logMemory(const std::string &filePath) const;
+
+    void useSkyboxShader();
+
+    void restoreSession();
+
+    void saveSession();
+
     Camera _camera{};
     Model _skybox{};
+    Shader _skyboxShaders[4]{};// indexed by flip | gamma << 1, compiled on first use
     Shader _renderCubeMapShader{};
+    Texture2D _panorama{};// source of the generated cubemap, reused by the next load of the same size
+    GpuTimer _skyboxTimer{};
+    FramePacer _framePacer{};
+    RenderTexture2D _sceneTarget{};// 3D scene at _renderScale when dynamic resolution is on
+    float _renderScale{1.0f};
+    float _renderScaleSmoothed{1.0f};
+    RenderTexture2D _overlay{};// info, help and tips, re-rendered only when overlayKey() changes
+    unsigned long long _overlayKey{0};
+    double _statsTime{0.0};
+    float _skyboxMs{-1.0f};// _skyboxTimer sampled at a low rate, so the overlay does not change every frame
+    float _latencyMs{-1.0f};// same for _framePacer
+    std::unique_ptr<HttpDownload> _download;// the current file, while it streams in
+    float _downloadProgress{-1.0f};
+    BufferPoolStats _bufferStats{};// sampled like _skyboxMs
+    unsigned long long _residentMemory{0};
+    std::unique_ptr<ShmFeed> _liveFeed;// the current file when it is a shm:// source
+    bool _liveFramePending{false};// a new frame went to the cubemap, its latency is taken after present
+    float _liveLatencyMs{-1.0f};// producer timestamp to present, smoothed
+    float _liveFps{-1.0f};// sampled like _skyboxMs
+    float _liveLatencySampleMs{-1.0f};
+    unsigned long long _liveDropped{0};
+    unsigned long long _liveShownAtSample{0};
 
     int _ratioIndex{0};
     int _textureSize{1024};
@@ -54,6 +113,13 @@ private:
     int _currentFileIndex{-1};
     bool _reload{false};
     bool _showHelp{false};
+    bool _lazyReload{false};// load at the end of the frame, after the window has something to show
+    double _startTime{0.0};
+    float _startupMs{-1.0f};
+    bool _restoring{false};
+    bool _restoredFromPreview{false};
+    float _restoreMs{-1.0f};
+    unsigned long long _frameAllocations{0};
 };
 
 #endif//VIEW360_APP_H
@@ -0,0 +1,138 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "buffer_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+
+static const size_t gMinClassSize = 64 * 1024;
+static const size_t gMaxIdleBytes = 256 * 1024 * 1024;
+
+// idle blocks by capacity
+struct BufferPool {
+    std::mutex mutex;
+    std::multimap<size_t, unsigned char *> idle;
+    BufferPoolStats stats;
+};
+
+// never destroyed, cancelled http transfers may still release buffers while the program exits
+static BufferPool &getPool() {
+    static auto *pool = new BufferPool();
+    return *pool;
+}
+
+// 2^n * {4, 5, 6, 7} / 4, so a block is at most 25% larger than asked for
+static size_t classSize(size_t size) {
+    size_t base = gMinClassSize;
+    while (base * 2 <= size) {
+        base *= 2;
+    }
+    for (size_t quarter = 4; quarter <= 8; quarter++) {
+        size_t candidate = base / 4 * quarter;
+        if (candidate >= size) {
+            return candidate;
+        }
+    }
+    return base * 2;
+}
+
+static unsigned char *acquireBlock(size_t size, size_t &capacity) {
+    BufferPool &pool = getPool();
+    capacity = classSize(size);
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        // a block of the next class up is fine too, beyond that it wastes too much
+        auto it = pool.idle.lower_bound(capacity);
+        if (it != pool.idle.end() && it->first <= capacity + capacity / 4) {
+            unsigned char *block = it->second;
+            capacity = it->first;
+            pool.idle.erase(it);
+            pool.stats.reuses++;
+            pool.stats.bytesIdle -= capacity;
+            pool.stats.bytesInUse += capacity;
+            return block;
+        }
+        pool.stats.allocations++;
+        pool.stats.bytesInUse += capacity;
+    }
+    auto *block = (unsigned char *) malloc(capacity);
+    if (!block) {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stats.bytesInUse -= capacity;
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+static void releaseBlock(unsigned char *block, size_t capacity) {
+    BufferPool &pool = getPool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.stats.bytesInUse -= capacity;
+        if (pool.stats.bytesIdle + capacity <= gMaxIdleBytes) {
+            pool.idle.emplace(capacity, block);
+            pool.stats.bytesIdle += capacity;
+            return;
+        }
+    }
+    free(block);
+}
+
+PooledBuffer::PooledBuffer(size_t size) {
+    resize(size);
+}
+
+PooledBuffer::~PooledBuffer() {
+    release();
+}
+
+PooledBuffer::PooledBuffer(PooledBuffer &&other) noexcept
+    : _data(other._data), _size(other._size), _capacity(other._capacity) {
+    other._data = nullptr;
+    other._size = 0;
+    other._capacity = 0;
+}
+
+PooledBuffer &PooledBuffer::operator=(PooledBuffer &&other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_capacity, other._capacity);
+    }
+    return *this;
+}
+
+void PooledBuffer::resize(size_t size) {
+    if (size > _capacity) {
+        size_t capacity = 0;
+        unsigned char *block = acquireBlock(size, capacity);
+        if (_data) {
+            memcpy(block, _data, _size);
+            releaseBlock(_data, _capacity);
+        }
+        _data = block;
+        _capacity = capacity;
+    }
+    _size = size;
+}
+
+void PooledBuffer::release() {
+    if (_data) {
+        releaseBlock(_data, _capacity);
+    }
+    _data = nullptr;
+    _size = 0;
+    _capacity = 0;
+}
+
+extern BufferPoolStats getBufferPoolStats() {
+    BufferPool &pool = getPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.stats;
+}
@@ -0,0 +1,58 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_BUFFER_POOL_H
+#define VIEW360_BUFFER_POOL_H
+
+#include <cstddef>
+
+// Byte buffer whose memory comes from a size-classed pool shared by all threads. Encoded files,
+// inflated zip entries and downloads are tens of MB each, recycling them keeps browsing from
+// allocating and freeing that much on every step. Contents are not initialized.
+class PooledBuffer {
+public:
+    PooledBuffer() = default;
+
+    explicit PooledBuffer(size_t size);
+
+    // the memory goes back to the pool
+    ~PooledBuffer();
+
+    PooledBuffer(PooledBuffer &&other) noexcept;
+
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept;
+
+    PooledBuffer(const PooledBuffer &) = delete;
+
+    PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+    // keeps the first min(old, new) bytes
+    void resize(size_t size);
+
+    void release();
+
+    unsigned char *data() { return _data; }
+
+    const unsigned char *data() const { return _data; }
+
+    size_t size() const { return _size; }
+
+    bool empty() const { return _size == 0; }
+
+private:
+    unsigned char *_data{nullptr};
+    size_t _size{0};
+    size_t _capacity{0};
+};
+
+struct BufferPoolStats {
+    unsigned long long allocations = 0;// blocks taken from the system
+    unsigned long long reuses = 0;// requests served by an idle block
+    size_t bytesInUse = 0;
+    size_t bytesIdle = 0;
+};
+
+extern BufferPoolStats getBufferPoolStats();
+
+#endif//VIEW360_BUFFER_POOL_H
@@ -9,32 +9,57 @@
 
 extern std::string get_config_path(const std::string &appName);
 
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Config,
-                                   ratioScale,
-                                   gammaCorrect,
-                                   flipImage,
-                                   needGenCubeMap,
-                                   showInfo,
-                                   showGrid,
-                                   minFov,
-                                   maxFov,
-                                   stepFov,
-                                   defaultFov,
-                                   inverseWheel,
-                                   fontSize)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(Config,
+                                                ratioScale,
+                                                gammaCorrect,
+                                                flipImage,
+                                                needGenCubeMap,
+                                                showInfo,
+                                                showGrid,
+                                                minFov,
+                                                maxFov,
+                                                stepFov,
+                                                defaultFov,
+                                                inverseWheel,
+                                                fontSize,
+                                                restoreSession,
+                                                dynamicResolution,
+                                                frameBudgetMs,
+                                                minRenderScale,
+                                                lowLatency,
+                                                httpConnections)
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(Session,
+                                                fileList,
+                                                currentFileIndex,
+                                                textureSize,
+                                                cameraPosition,
+                                                cameraTarget,
+                                                fovy,
+                                                previewFile)
 
 
 static const char *gConfigFile = "config.json";
 static const char *gAppName = "view360";
+static const char *gSessionKey = "session";
 
 extern Config *getConfig() {
     static Config config;
     return &config;
 }
 
+extern Session *getSession() {
+    static Session session;
+    return &session;
+}
+
+extern std::string getConfigDir() {
+    return get_config_path(gAppName);
+}
+
 extern void loadConfig() {
     try {
-        std::string path = get_config_path(gAppName) + "/" + gConfigFile;
+        std::string path = getConfigDir() + "/" + gConfigFile;
 
         nlohmann::json json;
         std::ifstream in(path);
@@ -44,6 +69,10 @@ extern void loadConfig() {
 
             auto *cfg = getConfig();
             from_json(json, *cfg);
+
+            if (json.contains(gSessionKey)) {
+                from_json(json[gSessionKey], *getSession());
+            }
         }
 
     } catch (std::exception &e) {
@@ -57,8 +86,9 @@ extern void saveConfig() {
         nlohmann::json json;
         auto *cfg = getConfig();
         to_json(json, *cfg);
+        to_json(json[gSessionKey], *getSession());
 
-        std::string path = get_config_path(gAppName) + "/" + gConfigFile;
+        std::string path = getConfigDir() + "/" + gConfigFile;
 
         std::ofstream out(path);
         if (out.is_open()) {
@@ -5,6 +5,10 @@
 #ifndef VIEW360_CONFIG_H
 #define VIEW360_CONFIG_H
 
+#include <array>
+#include <string>
+#include <vector>
+
 struct Config {
     float ratioScale = 50;
     bool gammaCorrect = true;
@@ -18,10 +22,31 @@ struct Config {
     float defaultFov = 45.0f;
     bool inverseWheel = true;
     int fontSize = 10;
+    bool restoreSession = true;
+    bool dynamicResolution = false;
+    float frameBudgetMs = 16.6f;
+    float minRenderScale = 0.5f;
+    bool lowLatency = false;
+    int httpConnections = 4;
+};
+
+// state of the last run, restored on startup when Config::restoreSession is set
+struct Session {
+    std::vector<std::string> fileList;
+    int currentFileIndex = -1;
+    int textureSize = 1024;
+    std::array<float, 3> cameraPosition{1.0f, 1.0f, 1.0f};
+    std::array<float, 3> cameraTarget{4.0f, 1.0f, 4.0f};
+    float fovy = 0.0f;// 0: use Config::defaultFov
+    std::string previewFile;// file the cached preview was rendered from
 };
 
 extern Config *getConfig();
+extern Session *getSession();
 extern void loadConfig();
 extern void saveConfig();
 
+// per-user directory holding config.json and the caches, ends with a path separator
+extern std::string getConfigDir();
+
 #endif//VIEW360_CONFIG_H
@@ -0,0 +1,120 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "frame_pacer.h"
+#include "gl_ext.h"
+#include <algorithm>
+#include <raylib.h>
+
+// raylib's PollInputEvents also rolls the previous input state, which would drop the key
+// presses and mouse motion already polled by EndDrawing. The GLFW poll only adds new events.
+extern "C" void glfwPollEvents(void);
+
+static const int gDefaultTargetFps = 60;
+static const double gWakeMargin = 0.002;// seconds kept between the predicted render end and the vblank
+static const double gFenceTimeout = 0.1;
+static const float gLatencySmoothing = 0.1f;
+
+void FramePacer::unload() {
+    const GLExt *gl = getGLExt();
+    for (int i = 0; i < _pendingCount; ++i) {
+        gl->DeleteSync(_pending[i].fence);
+    }
+    _pendingCount = 0;
+}
+
+void FramePacer::setLowLatency(bool enabled) {
+    const GLExt *gl = getGLExt();
+    bool supported = gl->FenceSync && gl->ClientWaitSync && gl->DeleteSync;
+    if (enabled && !supported) {
+        TraceLog(LOG_WARNING, "PACING: Fences not supported, low latency mode unavailable");
+        enabled = false;
+    }
+
+    if (_latencyMs >= 0.0f) {
+        TraceLog(LOG_INFO, "PACING: %s mode latency %.1f ms", _lowLatency ? "Low latency" : "VSync", _latencyMs);
+    }
+    _lowLatency = enabled;
+    _latencyMs = -1.0f;
+    _predictedCost = 0.0;
+
+    // vsync stays on in both modes, low latency mode replaces the frame limiter with its own wait
+    SetTargetFPS(enabled ? 0 : gDefaultTargetFps);
+}
+
+void FramePacer::collectFences(bool wait) {
+    const GLExt *gl = getGLExt();
+    while (_pendingCount > 0) {
+        PendingFrame &frame = _pending[0];
+        unsigned long long timeout = wait ? (unsigned long long) (gFenceTimeout * 1e9) : 0;
+        unsigned int status = gl->ClientWaitSync(frame.fence, VIEW360_GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+        if (status != VIEW360_GL_ALREADY_SIGNALED && status != VIEW360_GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        double now = GetTime();
+        _lastPresent = now;
+        if (frame.inputTime > 0.0) {
+            float latency = (float) ((now - frame.inputTime) * 1000.0);
+            _latencyMs = _latencyMs < 0.0f ? latency : _latencyMs + (latency - _latencyMs) * gLatencySmoothing;
+        }
+
+        gl->DeleteSync(frame.fence);
+        std::copy(_pending + 1, _pending + _pendingCount, _pending);
+        --_pendingCount;
+    }
+}
+
+void FramePacer::beginFrame() {
+    if (!getGLExt()->ClientWaitSync) {
+        return;
+    }
+
+    // frames in flight limited to one: the previous frame is on screen before this one starts
+    collectFences(_lowLatency);
+
+    if (!_lowLatency) {
+        return;
+    }
+
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    double period = 1.0 / (refreshRate > 0 ? refreshRate : gDefaultTargetFps);
+    double wakeup = _lastPresent + period - _predictedCost - gWakeMargin;
+    double now = GetTime();
+    if (wakeup > now) {
+        WaitTime(wakeup - now);
+    }
+
+    glfwPollEvents();
+    _inputTime = GetTime();
+}
+
+void FramePacer::beforePresent(float gpuMs) {
+    if (!_lowLatency) {
+        return;
+    }
+
+    // peak hold with slow decay, a late wakeup costs a whole frame while an early one costs little
+    double cost = GetTime() - _inputTime + std::max(gpuMs, 0.0f) / 1000.0;
+    _predictedCost = std::max(cost, _predictedCost * 0.98);
+}
+
+void FramePacer::endFrame() {
+    const GLExt *gl = getGLExt();
+    if (!gl->FenceSync) {
+        return;
+    }
+
+    if (_pendingCount == kMaxFences) {
+        collectFences(true);
+    }
+    if (_pendingCount < kMaxFences) {
+        _pending[_pendingCount++] = {gl->FenceSync(VIEW360_GL_SYNC_GPU_COMMANDS_COMPLETE, 0), _inputTime};
+    }
+
+    // EndDrawing polled input last, that is what the next frame uses in the default mode
+    if (!_lowLatency) {
+        _inputTime = GetTime();
+    }
+}
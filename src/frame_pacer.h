@@ -0,0 +1,63 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_FRAME_PACER_H
+#define VIEW360_FRAME_PACER_H
+
+// Frame pacing around EndDrawing, and input-to-present latency measurement.
+//
+// Default mode is raylib's: vsync plus SetTargetFPS(60), input is polled inside EndDrawing
+// and the driver may queue frames ahead. Low latency mode keeps one frame in flight, sleeps
+// until the predicted render cost before the next vblank, and only then samples input.
+//
+// Presentation is taken as the moment a fence inserted after the swap signals. In low latency
+// mode that fence is waited on, in the default mode it is polled once per frame, so the default
+// mode latency is accurate to about one frame.
+class FramePacer {
+public:
+    FramePacer() = default;
+
+    FramePacer(const FramePacer &) = delete;
+
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    // must run while the GL context is still alive
+    void unload();
+
+    void setLowLatency(bool enabled);
+
+    bool isLowLatency() const { return _lowLatency; }
+
+    // before handling input
+    void beginFrame();
+
+    // right before EndDrawing, with the GPU time of the frame if known
+    void beforePresent(float gpuMs);
+
+    // right after EndDrawing
+    void endFrame();
+
+    // smoothed input-to-present latency, negative until measured
+    float latencyMs() const { return _latencyMs; }
+
+private:
+    static constexpr int kMaxFences = 4;
+
+    struct PendingFrame {
+        void *fence;
+        double inputTime;
+    };
+
+    void collectFences(bool wait);
+
+    bool _lowLatency{false};
+    PendingFrame _pending[kMaxFences]{};
+    int _pendingCount{0};
+    double _inputTime{0.0};
+    double _lastPresent{0.0};
+    double _predictedCost{0.0};
+    float _latencyMs{-1.0f};
+};
+
+#endif//VIEW360_FRAME_PACER_H
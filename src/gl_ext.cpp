@@ -0,0 +1,46 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "gl_ext.h"
+
+// raylib links GLFW statically and keeps its symbols visible, so the loader can be borrowed from it.
+typedef void (*GLFWglproc)(void);
+extern "C" GLFWglproc glfwGetProcAddress(const char *procname);
+
+template<typename T>
+static void loadProc(T &proc, const char *name) {
+    proc = reinterpret_cast<T>(glfwGetProcAddress(name));
+}
+
+extern const GLExt *getGLExt() {
+    static GLExt ext;
+    if (!ext.loaded) {
+        loadProc(ext.GetString, "glGetString");
+        loadProc(ext.GetIntegerv, "glGetIntegerv");
+
+        loadProc(ext.BindTexture, "glBindTexture");
+        loadProc(ext.PixelStorei, "glPixelStorei");
+        loadProc(ext.TexSubImage2D, "glTexSubImage2D");
+
+        loadProc(ext.CreateProgram, "glCreateProgram");
+        loadProc(ext.DeleteProgram, "glDeleteProgram");
+        loadProc(ext.GetProgramiv, "glGetProgramiv");
+        loadProc(ext.GetProgramBinary, "glGetProgramBinary");
+        loadProc(ext.ProgramBinary, "glProgramBinary");
+
+        loadProc(ext.GenQueries, "glGenQueries");
+        loadProc(ext.DeleteQueries, "glDeleteQueries");
+        loadProc(ext.BeginQuery, "glBeginQuery");
+        loadProc(ext.EndQuery, "glEndQuery");
+        loadProc(ext.GetQueryObjectiv, "glGetQueryObjectiv");
+        loadProc(ext.GetQueryObjectui64v, "glGetQueryObjectui64v");
+
+        loadProc(ext.FenceSync, "glFenceSync");
+        loadProc(ext.ClientWaitSync, "glClientWaitSync");
+        loadProc(ext.DeleteSync, "glDeleteSync");
+
+        ext.loaded = true;
+    }
+    return &ext;
+}
@@ -0,0 +1,73 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_GL_EXT_H
+#define VIEW360_GL_EXT_H
+
+// OpenGL entry points that raylib/rlgl do not expose, resolved at runtime through GLFW.
+// Every pointer may be null when the context does not provide the function.
+
+#if defined(_WIN32) && !defined(_WIN64)
+#define VIEW360_GLAPI __stdcall
+#else
+#define VIEW360_GLAPI
+#endif
+
+#define VIEW360_GL_VENDOR 0x1F00
+#define VIEW360_GL_RENDERER 0x1F01
+#define VIEW360_GL_VERSION 0x1F02
+#define VIEW360_GL_LINK_STATUS 0x8B82
+#define VIEW360_GL_PROGRAM_BINARY_LENGTH 0x8741
+#define VIEW360_GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define VIEW360_GL_TIME_ELAPSED 0x88BF
+#define VIEW360_GL_QUERY_RESULT 0x8866
+#define VIEW360_GL_QUERY_RESULT_AVAILABLE 0x8867
+#define VIEW360_GL_TEXTURE_2D 0x0DE1
+#define VIEW360_GL_TEXTURE_CUBE_MAP 0x8513
+#define VIEW360_GL_TEXTURE_CUBE_MAP_POSITIVE_X 0x8515
+#define VIEW360_GL_UNPACK_ROW_LENGTH 0x0CF2
+#define VIEW360_GL_UNPACK_SKIP_ROWS 0x0CF3
+#define VIEW360_GL_UNPACK_SKIP_PIXELS 0x0CF4
+#define VIEW360_GL_UNPACK_ALIGNMENT 0x0CF5
+#define VIEW360_GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define VIEW360_GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define VIEW360_GL_ALREADY_SIGNALED 0x911A
+#define VIEW360_GL_CONDITION_SATISFIED 0x911C
+
+struct GLExt {
+    bool loaded = false;
+
+    const unsigned char *(VIEW360_GLAPI *GetString)(unsigned int name) = nullptr;
+    void(VIEW360_GLAPI *GetIntegerv)(unsigned int pname, int *data) = nullptr;
+
+    // sub-rectangle uploads
+    void(VIEW360_GLAPI *BindTexture)(unsigned int target, unsigned int texture) = nullptr;
+    void(VIEW360_GLAPI *PixelStorei)(unsigned int pname, int param) = nullptr;
+    void(VIEW360_GLAPI *TexSubImage2D)(unsigned int target, int level, int xoffset, int yoffset, int width, int height, unsigned int format, unsigned int type, const void *pixels) = nullptr;
+
+    // program binaries (GL 4.1 / ARB_get_program_binary)
+    unsigned int(VIEW360_GLAPI *CreateProgram)() = nullptr;
+    void(VIEW360_GLAPI *DeleteProgram)(unsigned int program) = nullptr;
+    void(VIEW360_GLAPI *GetProgramiv)(unsigned int program, unsigned int pname, int *params) = nullptr;
+    void(VIEW360_GLAPI *GetProgramBinary)(unsigned int program, int bufSize, int *length, unsigned int *binaryFormat, void *binary) = nullptr;
+    void(VIEW360_GLAPI *ProgramBinary)(unsigned int program, unsigned int binaryFormat, const void *binary, int length) = nullptr;
+
+    // timer queries (GL 3.3 / ARB_timer_query)
+    void(VIEW360_GLAPI *GenQueries)(int n, unsigned int *ids) = nullptr;
+    void(VIEW360_GLAPI *DeleteQueries)(int n, const unsigned int *ids) = nullptr;
+    void(VIEW360_GLAPI *BeginQuery)(unsigned int target, unsigned int id) = nullptr;
+    void(VIEW360_GLAPI *EndQuery)(unsigned int target) = nullptr;
+    void(VIEW360_GLAPI *GetQueryObjectiv)(unsigned int id, unsigned int pname, int *params) = nullptr;
+    void(VIEW360_GLAPI *GetQueryObjectui64v)(unsigned int id, unsigned int pname, unsigned long long *params) = nullptr;
+
+    // fences (GL 3.2 / ARB_sync), GLsync handles are opaque pointers
+    void *(VIEW360_GLAPI *FenceSync)(unsigned int condition, unsigned int flags) = nullptr;
+    unsigned int(VIEW360_GLAPI *ClientWaitSync)(void *sync, unsigned int flags, unsigned long long timeout) = nullptr;
+    void(VIEW360_GLAPI *DeleteSync)(void *sync) = nullptr;
+};
+
+// Must be called with a current context, i.e. after InitWindow().
+extern const GLExt *getGLExt();
+
+#endif//VIEW360_GL_EXT_H
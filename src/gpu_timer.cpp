@@ -0,0 +1,65 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "gpu_timer.h"
+#include "gl_ext.h"
+#include <rlgl.h>
+
+void GpuTimer::unload() {
+    if (_supported) {
+        getGLExt()->DeleteQueries(kQueryCount, _queries);
+    }
+    _initialized = false;
+    _supported = false;
+    _running = false;
+    for (bool &pending: _pending) pending = false;
+}
+
+void GpuTimer::init() {
+    _initialized = true;
+    const GLExt *gl = getGLExt();
+    _supported = gl->GenQueries && gl->DeleteQueries && gl->BeginQuery && gl->EndQuery && gl->GetQueryObjectiv && gl->GetQueryObjectui64v;
+    if (_supported) {
+        gl->GenQueries(kQueryCount, _queries);
+    }
+}
+
+void GpuTimer::begin() {
+    if (!_initialized) init();
+    if (!_supported || _running) return;
+
+    const GLExt *gl = getGLExt();
+
+    // collect finished queries from oldest to newest, the newest one wins
+    for (int i = 0; i < kQueryCount; ++i) {
+        int index = (_current + i) % kQueryCount;
+        if (!_pending[index]) continue;
+        int available = 0;
+        gl->GetQueryObjectiv(_queries[index], VIEW360_GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            unsigned long long ns = 0;
+            gl->GetQueryObjectui64v(_queries[index], VIEW360_GL_QUERY_RESULT, &ns);
+            _lastMs = (float) ((double) ns / 1.0e6);
+            _pending[index] = false;
+        }
+    }
+
+    // all queries still in flight, skip this sample
+    if (_pending[_current]) return;
+
+    // flush batched draws so they are not counted in the measured block
+    rlDrawRenderBatchActive();
+    gl->BeginQuery(VIEW360_GL_TIME_ELAPSED, _queries[_current]);
+    _running = true;
+}
+
+void GpuTimer::end() {
+    if (!_running) return;
+
+    rlDrawRenderBatchActive();
+    getGLExt()->EndQuery(VIEW360_GL_TIME_ELAPSED);
+    _pending[_current] = true;
+    _current = (_current + 1) % kQueryCount;
+    _running = false;
+}
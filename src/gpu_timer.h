@@ -0,0 +1,44 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_GPU_TIMER_H
+#define VIEW360_GPU_TIMER_H
+
+// Measures GPU time of a block of draw calls with GL_TIME_ELAPSED queries.
+// Results are read back a few frames late so the CPU never waits on the GPU.
+class GpuTimer {
+public:
+    GpuTimer() = default;
+
+    GpuTimer(const GpuTimer &) = delete;
+
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    // must run while the GL context is still alive
+    void unload();
+
+    void begin();
+
+    void end();
+
+    bool isSupported() const { return _supported; }
+
+    // last resolved measurement in milliseconds, negative until the first one arrives
+    float lastMs() const { return _lastMs; }
+
+private:
+    static constexpr int kQueryCount = 4;
+
+    void init();
+
+    bool _initialized{false};
+    bool _supported{false};
+    bool _running{false};
+    unsigned int _queries[kQueryCount]{};
+    bool _pending[kQueryCount]{};
+    int _current{0};
+    float _lastMs{-1.0f};
+};
+
+#endif//VIEW360_GPU_TIMER_H
@@ -0,0 +1,370 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "http_client.h"
+#include "buffer_pool.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <raylib.h>
+
+#if defined(_WIN32)
+// keeps windows.h from declaring names that clash with raylib
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+#define VIEW360_INVALID_SOCKET INVALID_SOCKET
+#define closeSocket closesocket
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int socket_t;
+#define VIEW360_INVALID_SOCKET (-1)
+#define closeSocket close
+#endif
+
+static const int gSocketTimeoutMs = 10000;
+static const int gPollIntervalMs = 100;
+static const size_t gReceiveSize = 64 * 1024;
+static const size_t gMaxHeaderSize = 64 * 1024;
+static const size_t gMaxIdleConnections = 8;
+
+static void setBlocking(socket_t s, bool blocking) {
+#if defined(_WIN32)
+    u_long nonBlocking = blocking ? 0 : 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    fcntl(s, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+#endif
+}
+
+static bool isConnectPending() {
+#if defined(_WIN32)
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EINPROGRESS;
+#endif
+}
+
+class HttpConnection {
+public:
+    HttpConnection(std::string host, int port) : _host(std::move(host)), _port(port) {}
+
+    ~HttpConnection() {
+        if (_socket != VIEW360_INVALID_SOCKET) closeSocket(_socket);
+    }
+
+    HttpConnection(const HttpConnection &) = delete;
+
+    HttpConnection &operator=(const HttpConnection &) = delete;
+
+    bool connect();
+
+    bool sendAll(const std::string &data);
+
+    // buffered reads, bytes received past the current response are kept for the next one
+    bool readLine(std::string &line);
+
+    long receive(unsigned char *buffer, size_t size);
+
+    bool matches(const HttpUrl &url) const { return _host == url.host && _port == url.port; }
+
+    // a fresh connection that fails is a real error, a reused one may just have been closed by the server
+    bool isReused() const { return _reused; }
+
+    void setReused() { _reused = true; }
+
+    void setCancelCheck(const std::function<bool()> *isCancelled) { _isCancelled = isCancelled; }
+
+    bool isCancelled() const { return _isCancelled && *_isCancelled && (*_isCancelled)(); }
+
+private:
+    // waits in short slices so cancellation is noticed, false on timeout, error or cancel
+    bool wait(bool forWrite);
+
+    long fill();
+
+    std::string _host;
+    int _port;
+    socket_t _socket{VIEW360_INVALID_SOCKET};
+    bool _reused{false};
+    const std::function<bool()> *_isCancelled{nullptr};
+    std::vector<unsigned char> _buffer;
+    size_t _bufferPos{0};
+};
+
+bool HttpConnection::wait(bool forWrite) {
+    for (int waited = 0; waited < gSocketTimeoutMs; waited += gPollIntervalMs) {
+        if (isCancelled()) {
+            return false;
+        }
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(_socket, &set);
+        timeval timeout{0, gPollIntervalMs * 1000};
+        int n = select((int) _socket + 1, forWrite ? nullptr : &set, forWrite ? &set : nullptr, nullptr, &timeout);
+        if (n != 0) return n > 0;
+    }
+    TraceLog(LOG_WARNING, "HTTP: [%s:%d] Timed out", _host.c_str(), _port);
+    return false;
+}
+
+bool HttpConnection::connect() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result = nullptr;
+    char port[16];
+    snprintf(port, sizeof(port), "%d", _port);
+    if (getaddrinfo(_host.c_str(), port, &hints, &result) != 0) {
+        TraceLog(LOG_WARNING, "HTTP: [%s] Failed to resolve host", _host.c_str());
+        return false;
+    }
+
+    for (addrinfo *ai = result; ai && _socket == VIEW360_INVALID_SOCKET; ai = ai->ai_next) {
+        socket_t s = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (s == VIEW360_INVALID_SOCKET) continue;
+
+        // non-blocking connect, an unreachable host would otherwise block for the OS timeout
+        setBlocking(s, false);
+        bool connected = ::connect(s, ai->ai_addr, (int) ai->ai_addrlen) == 0;
+        if (!connected && isConnectPending()) {
+            _socket = s;
+            int error = 0;
+            socklen_t length = sizeof(error);
+            connected = wait(true) && getsockopt(s, SOL_SOCKET, SO_ERROR, (char *) &error, &length) == 0 && error == 0;
+            _socket = VIEW360_INVALID_SOCKET;
+        }
+        if (connected) {
+            setBlocking(s, true);
+            _socket = s;
+        } else {
+            closeSocket(s);
+        }
+    }
+    freeaddrinfo(result);
+    if (_socket == VIEW360_INVALID_SOCKET) {
+        if (isCancelled()) return false;
+        TraceLog(LOG_WARNING, "HTTP: [%s:%d] Failed to connect", _host.c_str(), _port);
+        return false;
+    }
+
+    int noDelay = 1;
+    setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, (const char *) &noDelay, sizeof(noDelay));
+    return true;
+}
+
+bool HttpConnection::sendAll(const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        if (!wait(true)) return false;
+        int flags = 0;
+#if defined(MSG_NOSIGNAL)
+        flags = MSG_NOSIGNAL;
+#endif
+        long n = (long) send(_socket, data.data() + sent, (int) (data.size() - sent), flags);
+        if (n <= 0) return false;
+        sent += (size_t) n;
+    }
+    return true;
+}
+
+long HttpConnection::fill() {
+    _buffer.resize(gReceiveSize);
+    _bufferPos = 0;
+    long n = wait(false) ? (long) recv(_socket, (char *) _buffer.data(), (int) _buffer.size(), 0) : -1;
+    _buffer.resize(n > 0 ? (size_t) n : 0);
+    return n;
+}
+
+long HttpConnection::receive(unsigned char *buffer, size_t size) {
+    if (_bufferPos == _buffer.size()) {
+        long n = fill();
+        if (n <= 0) return n;
+    }
+    size_t n = std::min(size, _buffer.size() - _bufferPos);
+    memcpy(buffer, _buffer.data() + _bufferPos, n);
+    _bufferPos += n;
+    return (long) n;
+}
+
+bool HttpConnection::readLine(std::string &line) {
+    line.clear();
+    while (line.size() < gMaxHeaderSize) {
+        if (_bufferPos == _buffer.size() && fill() <= 0) {
+            return false;
+        }
+        char c = (char) _buffer[_bufferPos++];
+        if (c == '\n') {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            return true;
+        }
+        line.push_back(c);
+    }
+    return false;
+}
+
+extern bool parseHttpUrl(const std::string &url, HttpUrl &out) {
+    static const char *scheme = "http://";
+    if (url.compare(0, strlen(scheme), scheme) != 0) return false;
+
+    size_t hostStart = strlen(scheme);
+    size_t pathStart = url.find_first_of("/?#", hostStart);
+    std::string authority = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+    if (authority.find('@') != std::string::npos) return false;
+
+    out.port = 80;
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos && authority.find(']', colon) == std::string::npos) {
+        out.port = atoi(authority.c_str() + colon + 1);
+        authority.resize(colon);
+    }
+    if (authority.size() > 2 && authority.front() == '[' && authority.back() == ']') {
+        authority = authority.substr(1, authority.size() - 2);
+    }
+    if (authority.empty() || out.port <= 0 || out.port > 65535) return false;
+    out.host = authority;
+
+    out.target = pathStart == std::string::npos ? "/" : url.substr(pathStart);
+    size_t fragment = out.target.find('#');
+    if (fragment != std::string::npos) out.target.resize(fragment);
+    if (out.target.empty() || out.target.front() != '/') out.target.insert(0, "/");
+    return true;
+}
+
+static std::string toLower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return (char) tolower(c); });
+    return str;
+}
+
+HttpConnectionPool::HttpConnectionPool() {
+#if defined(_WIN32)
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    _idle.clear();
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+std::unique_ptr<HttpConnection> HttpConnectionPool::acquire(const HttpUrl &url, const std::function<bool()> *isCancelled) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _idle.begin(); it != _idle.end(); ++it) {
+            if ((*it)->matches(url)) {
+                std::unique_ptr<HttpConnection> connection = std::move(*it);
+                _idle.erase(it);
+                connection->setCancelCheck(isCancelled);
+                return connection;
+            }
+        }
+    }
+    auto connection = std::make_unique<HttpConnection>(url.host, url.port);
+    connection->setCancelCheck(isCancelled);
+    return connection->connect() ? std::move(connection) : nullptr;
+}
+
+void HttpConnectionPool::release(std::unique_ptr<HttpConnection> connection) {
+    connection->setCancelCheck(nullptr);
+    connection->setReused();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_idle.size() < gMaxIdleConnections) {
+        _idle.push_back(std::move(connection));
+    }
+}
+
+bool HttpConnectionPool::get(const HttpUrl &url, int64_t first, int64_t last, const HttpResponseHandler &handler) {
+    std::string request = "GET " + url.target + " HTTP/1.1\r\n";
+    request += "Host: " + url.host + (url.port != 80 ? ":" + std::to_string(url.port) : "") + "\r\n";
+    request += "User-Agent: View360\r\n";
+    request += "Accept-Encoding: identity\r\n";
+    if (first >= 0) {
+        request += "Range: bytes=" + std::to_string(first) + "-" + (last >= 0 ? std::to_string(last) : "") + "\r\n";
+    }
+    request += "\r\n";
+
+    // a pooled connection may have been closed by the server meanwhile, retry once on a fresh one
+    std::unique_ptr<HttpConnection> connection;
+    std::string line;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        connection = acquire(url, &handler.isCancelled);
+        if (!connection) return false;
+        if (connection->sendAll(request) && connection->readLine(line)) break;
+        if (!connection->isReused()) return false;
+        connection.reset();
+    }
+    if (!connection) return false;
+
+    int status = 0;
+    if (sscanf(line.c_str(), "HTTP/%*d.%*d %d", &status) != 1) {
+        TraceLog(LOG_WARNING, "HTTP: [%s] Bad status line", url.host.c_str());
+        return false;
+    }
+
+    int64_t contentLength = -1;
+    int64_t totalSize = -1;
+    bool keepAlive = true;
+    while (true) {
+        if (!connection->readLine(line)) return false;
+        if (line.empty()) break;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = toLower(line.substr(0, colon));
+        size_t valueStart = line.find_first_not_of(' ', colon + 1);
+        std::string value = valueStart == std::string::npos ? "" : line.substr(valueStart);
+        if (name == "content-length") {
+            contentLength = strtoll(value.c_str(), nullptr, 10);
+        } else if (name == "content-range") {
+            size_t slash = value.rfind('/');
+            if (slash != std::string::npos && value[slash + 1] != '*') {
+                totalSize = strtoll(value.c_str() + slash + 1, nullptr, 10);
+            }
+        } else if (name == "connection") {
+            keepAlive = toLower(value).find("close") == std::string::npos;
+        } else if (name == "transfer-encoding" && toLower(value) != "identity") {
+            // panoramas are static files, servers send them with a length
+            TraceLog(LOG_WARNING, "HTTP: [%s] Unsupported transfer encoding '%s'", url.host.c_str(), value.c_str());
+            return false;
+        }
+    }
+    if (status == 200) totalSize = contentLength;
+
+    if (handler.onStart && !handler.onStart(status, totalSize, contentLength)) return false;
+    if (status != 200 && status != 206) return false;
+
+    PooledBuffer buffer(gReceiveSize);
+    int64_t received = 0;
+    while (contentLength < 0 || received < contentLength) {
+        size_t want = buffer.size();
+        if (contentLength >= 0) want = (size_t) std::min<int64_t>((int64_t) want, contentLength - received);
+        long n = connection->receive(buffer.data(), want);
+        if (n <= 0) break;
+        received += n;
+        if (handler.onData && !handler.onData(buffer.data(), (size_t) n)) return false;
+    }
+    if (contentLength >= 0 && received < contentLength) {
+        if (handler.isCancelled && handler.isCancelled()) return false;
+        TraceLog(LOG_WARNING, "HTTP: [%s] Connection dropped after %lld of %lld bytes", url.host.c_str(), (long long) received, (long long) contentLength);
+        return false;
+    }
+
+    if (keepAlive && contentLength >= 0) release(std::move(connection));
+    return true;
+}
@@ -0,0 +1,61 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_HTTP_CLIENT_H
+#define VIEW360_HTTP_CLIENT_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct HttpUrl {
+    std::string host;
+    int port = 80;
+    std::string target;// path and query, starts with '/'
+};
+
+// plain http only, the panorama servers are internal
+extern bool parseHttpUrl(const std::string &url, HttpUrl &out);
+
+struct HttpResponseHandler {
+    // called once the headers are in; totalSize is the size of the whole resource, -1 if unknown
+    // returning false aborts the transfer
+    std::function<bool(int status, int64_t totalSize, int64_t contentLength)> onStart;
+    // body bytes as they arrive
+    std::function<bool(const unsigned char *data, size_t size)> onData;
+    // polled while waiting on the network, so a stalled server cannot hold up cancellation
+    std::function<bool()> isCancelled;
+};
+
+class HttpConnection;
+
+// Minimal HTTP/1.1 GET client. Keep-alive connections are returned to the pool after each
+// complete response and reused by the next request to the same host, from any thread.
+class HttpConnectionPool {
+public:
+    HttpConnectionPool();
+
+    ~HttpConnectionPool();
+
+    HttpConnectionPool(const HttpConnectionPool &) = delete;
+
+    HttpConnectionPool &operator=(const HttpConnectionPool &) = delete;
+
+    // GET with an optional byte range [first, last], last < 0 for "to the end", first < 0 for no range.
+    // Returns false on network or protocol errors, or when a handler aborted.
+    bool get(const HttpUrl &url, int64_t first, int64_t last, const HttpResponseHandler &handler);
+
+private:
+    std::unique_ptr<HttpConnection> acquire(const HttpUrl &url, const std::function<bool()> *isCancelled);
+
+    void release(std::unique_ptr<HttpConnection> connection);
+
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<HttpConnection>> _idle;
+};
+
+#endif//VIEW360_HTTP_CLIENT_H
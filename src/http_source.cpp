@@ -0,0 +1,453 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "http_source.h"
+#include "buffer_pool.h"
+#include "config.h"
+#include "http_client.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const char *gCacheDir = "http_cache";
+static const int64_t gChunkSize = 1024 * 1024;
+static const int gMaxAttempts = 3;
+static const double gRefineInterval = 0.25;// seconds between progressive decodes
+
+// never destroyed, cancelled transfers may still be winding down while the program exits
+static HttpConnectionPool &getPool() {
+    static auto *pool = new HttpConnectionPool();
+    return *pool;
+}
+
+static double getClockSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Follows the marker structure of a jpeg while it arrives. Everything before the second and later
+// SOS markers belongs to complete scans, which decode on their own once an EOI is appended:
+// a progressive jpeg then shows all of its coefficients refined so far.
+struct JpegScanTracker {
+    int64_t pos = 0;
+    bool entropy = false;// inside entropy coded data, markers are only found by scanning
+    bool stopped = false;
+    int scans = 0;
+    int64_t completeEnd = 0;
+
+    void update(const unsigned char *data, int64_t size);
+};
+
+void JpegScanTracker::update(const unsigned char *data, int64_t size) {
+    while (!stopped && pos + 1 < size) {
+        if (pos == 0) {
+            stopped = data[0] != 0xFF || data[1] != 0xD8;
+            pos = 2;
+        } else if (entropy) {
+            const void *next = memchr(data + pos, 0xFF, (size_t) (size - pos - 1));
+            if (!next) {
+                pos = size - 1;
+                return;
+            }
+            pos = (const unsigned char *) next - data;
+            unsigned char marker = data[pos + 1];
+            if (marker == 0x00 || (marker >= 0xD0 && marker <= 0xD7)) {
+                pos += 2;// stuffed byte or restart marker
+            } else if (marker == 0xFF) {
+                pos += 1;
+            } else {
+                entropy = false;
+            }
+        } else {
+            if (data[pos] != 0xFF) {
+                stopped = true;
+                return;
+            }
+            unsigned char marker = data[pos + 1];
+            if (marker == 0xFF) {
+                pos += 1;// fill byte
+                continue;
+            }
+            if (marker == 0xD9) {
+                stopped = true;
+                return;
+            }
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+                pos += 2;// no length
+                continue;
+            }
+            if (pos + 4 > size) return;
+            int64_t length = (data[pos + 2] << 8) | data[pos + 3];
+            if (pos + 2 + length > size) return;// wait for the whole segment
+            if (marker == 0xDA) {
+                if (scans++ > 0) completeEnd = pos;
+                entropy = true;
+            }
+            pos += 2 + length;
+        }
+    }
+}
+
+extern bool isHttpSource(const std::string &source) {
+    return source.compare(0, 7, "http://") == 0;
+}
+
+extern std::string getHttpFileType(const std::string &url) {
+    HttpUrl parsed;
+    if (!parseHttpUrl(url, parsed)) return "";
+    std::string path = parsed.target.substr(0, parsed.target.find('?'));
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || path.find('/', dot) != std::string::npos) return "";
+    std::string fileType = path.substr(dot);
+    std::transform(fileType.begin(), fileType.end(), fileType.begin(), [](unsigned char c) { return (char) tolower(c); });
+    return fileType;
+}
+
+extern std::string getHttpCachePath(const std::string &url) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c: url) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%016llx", (unsigned long long) hash);
+    return getConfigDir() + gCacheDir + "/" + fileName + getHttpFileType(url);
+}
+
+// the state of one HttpDownload, kept alive by its threads until they are done
+class HttpTransfer {
+public:
+    HttpTransfer(std::string url, HttpUrl httpUrl, int connections);
+
+    ~HttpTransfer();
+
+    void run();
+
+    void cancel();
+
+    bool takeImage(Image &image, bool &complete);
+
+    float progress() const;
+
+    bool isFinished() const { return _finished; }
+
+    bool isFailed() const { return _failed; }
+
+private:
+    void fetch();
+
+    bool takeChunk(int &chunk);
+
+    bool fetchChunk(int chunk);
+
+    bool begin(int status, int64_t totalSize, int64_t contentLength, int chunk);
+
+    void store(int64_t offset, const unsigned char *data, size_t size);
+
+    int64_t contiguousSize() const;
+
+    void publish(Image image, bool complete);
+
+    void saveCache() const;
+
+    std::string _url;
+    HttpUrl _httpUrl;
+    std::string _fileType;
+    int _connections{1};
+    std::atomic<bool> _cancelled{false};
+    std::atomic<bool> _failed{false};
+    std::atomic<bool> _finished{false};
+    std::atomic<int64_t> _received{0};
+    std::atomic<int64_t> _totalSize{-1};
+
+    mutable std::mutex _mutex;
+    std::condition_variable _changed;
+    PooledBuffer _data;// written by the fetch threads, each into its own chunks
+    std::vector<int64_t> _chunkReceived;
+    int _nextChunk{0};
+    bool _ranged{true};
+    mutable int _prefixChunk{0};// chunks before it are complete
+
+    std::mutex _imageMutex;
+    Image _image{};
+    bool _imageComplete{false};
+
+    std::vector<std::thread> _fetchThreads;
+};
+
+HttpDownload::HttpDownload(std::string url) : _url(std::move(url)) {
+    HttpUrl httpUrl;
+    if (!parseHttpUrl(_url, httpUrl)) {
+        TraceLog(LOG_WARNING, "HTTP: [%s] Invalid url", _url.c_str());
+        return;
+    }
+    _transfer = std::make_shared<HttpTransfer>(_url, httpUrl, std::max(1, getConfig()->httpConnections));
+    std::thread([transfer = _transfer] { transfer->run(); }).detach();
+}
+
+HttpDownload::~HttpDownload() {
+    if (_transfer) {
+        _transfer->cancel();
+    }
+}
+
+bool HttpDownload::takeImage(Image &image, bool &complete) {
+    return _transfer && _transfer->takeImage(image, complete);
+}
+
+bool HttpDownload::isFinished() const {
+    return !_transfer || _transfer->isFinished();
+}
+
+bool HttpDownload::isFailed() const {
+    return !_transfer || _transfer->isFailed();
+}
+
+float HttpDownload::progress() const {
+    return _transfer ? _transfer->progress() : 0.0f;
+}
+
+HttpTransfer::HttpTransfer(std::string url, HttpUrl httpUrl, int connections)
+    : _url(std::move(url)), _httpUrl(std::move(httpUrl)), _fileType(getHttpFileType(_url)), _connections(connections) {}
+
+HttpTransfer::~HttpTransfer() {
+    if (_image.data) {
+        UnloadImage(_image);
+    }
+}
+
+void HttpTransfer::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cancelled = true;
+    }
+    _changed.notify_all();
+}
+
+bool HttpTransfer::takeImage(Image &image, bool &complete) {
+    std::lock_guard<std::mutex> lock(_imageMutex);
+    if (!_image.data) {
+        return false;
+    }
+    image = _image;
+    complete = _imageComplete;
+    _image = {0};
+    return true;
+}
+
+float HttpTransfer::progress() const {
+    int64_t total = _totalSize;
+    return total > 0 ? (float) _received / (float) total : 0.0f;
+}
+
+void HttpTransfer::run() {
+    double start = getClockSeconds();
+    for (int i = 0; i < _connections; i++) {
+        _fetchThreads.emplace_back(&HttpTransfer::fetch, this);
+    }
+
+    JpegScanTracker scans;
+    bool jpeg = _fileType == ".jpg";
+    int64_t available = 0;
+    int64_t decoded = 0;
+    double lastDecode = 0.0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _changed.wait_for(lock, std::chrono::milliseconds(100), [&] { return _cancelled || _failed || contiguousSize() != available; });
+            if (_cancelled || _failed) break;
+            available = contiguousSize();
+        }
+
+        if (_totalSize > 0 && available == _totalSize) {
+            Image image = LoadImageFromMemory(_fileType.c_str(), _data.data(), (int) _data.size());
+            if (!IsImageReady(image)) {
+                TraceLog(LOG_WARNING, "HTTP: [%s] Failed to decode", _url.c_str());
+                std::lock_guard<std::mutex> lock(_mutex);
+                _failed = true;
+                break;
+            }
+            TraceLog(LOG_INFO, "HTTP: [%s] %lld bytes in %.2f s", _url.c_str(), (long long) _data.size(), getClockSeconds() - start);
+            saveCache();
+            publish(image, true);
+            break;
+        }
+
+        // the prefix below `available` is never written again, so it can be read without the lock
+        if (!jpeg) continue;
+        scans.update(_data.data(), available);
+        double now = getClockSeconds();
+        if (scans.completeEnd > decoded && now - lastDecode >= gRefineInterval) {
+            PooledBuffer partial((size_t) scans.completeEnd + 2);
+            memcpy(partial.data(), _data.data(), (size_t) scans.completeEnd);
+            partial.data()[scans.completeEnd] = 0xFF;
+            partial.data()[scans.completeEnd + 1] = 0xD9;
+            Image image = LoadImageFromMemory(".jpg", partial.data(), (int) partial.size());
+            if (IsImageReady(image)) {
+                TraceLog(LOG_INFO, "HTTP: [%s] %d scans, %lld bytes decoded after %.2f s", _url.c_str(), scans.scans - 1, (long long) scans.completeEnd, now - start);
+                publish(image, false);
+            }
+            decoded = scans.completeEnd;
+            lastDecode = now;
+        }
+    }
+
+    _changed.notify_all();
+    for (auto &thread: _fetchThreads) {
+        thread.join();
+    }
+    _finished = true;
+}
+
+void HttpTransfer::fetch() {
+    int chunk = 0;
+    while (takeChunk(chunk)) {
+        if (!fetchChunk(chunk)) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _failed = true;
+            }
+            _changed.notify_all();
+            return;
+        }
+    }
+}
+
+bool HttpTransfer::takeChunk(int &chunk) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    // the first request learns the size, the other connections wait for it
+    _changed.wait(lock, [&] { return _cancelled || _failed || _nextChunk == 0 || _totalSize >= 0; });
+    if (_cancelled || _failed) {
+        return false;
+    }
+    if (_nextChunk > 0 && _nextChunk >= (int) _chunkReceived.size()) {
+        return false;
+    }
+    chunk = _nextChunk++;
+    return true;
+}
+
+bool HttpTransfer::fetchChunk(int chunk) {
+    for (int attempt = 0; attempt < gMaxAttempts && !_cancelled && !_failed; attempt++) {
+        int64_t first = 0;
+        int64_t last = gChunkSize - 1;
+        {
+            // resume after the bytes a dropped connection already delivered
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_totalSize >= 0) {
+                first = chunk * gChunkSize + _chunkReceived[chunk];
+                last = std::min<int64_t>(_totalSize, (chunk + 1) * gChunkSize) - 1;
+                if (first > last) return true;
+            }
+        }
+
+        int64_t offset = first;
+        HttpResponseHandler handler;
+        handler.onStart = [&](int status, int64_t totalSize, int64_t contentLength) {
+            return begin(status, totalSize, contentLength, chunk);
+        };
+        handler.onData = [&](const unsigned char *data, size_t size) {
+            if (_cancelled || _failed || offset + (int64_t) size > (int64_t) _data.size()) return false;
+            store(offset, data, size);
+            offset += (int64_t) size;
+            return true;
+        };
+        handler.isCancelled = [this] { return _cancelled || _failed; };
+        if (getPool().get(_httpUrl, first, last, handler)) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_ranged) break;// cannot resume without ranges
+    }
+    if (!_cancelled && !_failed) {
+        TraceLog(LOG_WARNING, "HTTP: [%s] Failed to fetch chunk %d", _url.c_str(), chunk);
+    }
+    return false;
+}
+
+bool HttpTransfer::begin(int status, int64_t totalSize, int64_t contentLength, int chunk) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_totalSize < 0) {
+        // 200: the server ignores ranges, the whole file arrives on this connection
+        int64_t size = status == 206 ? totalSize : status == 200 && chunk == 0 ? contentLength : -1;
+        if (size <= 0 || size > INT_MAX) {
+            TraceLog(LOG_WARNING, "HTTP: [%s] Status %d, size %lld", _url.c_str(), status, (long long) size);
+            _failed = true;// not worth a retry
+            _changed.notify_all();
+            return false;
+        }
+        _data.resize((size_t) size);
+        _chunkReceived.assign((size_t) ((size + gChunkSize - 1) / gChunkSize), 0);
+        _totalSize = size;
+        if (status == 200) {
+            _ranged = false;
+            _nextChunk = (int) _chunkReceived.size();
+        }
+        _changed.notify_all();
+        return true;
+    }
+    // a resumed range, or a changed file
+    return status == 206 && totalSize == _totalSize;
+}
+
+void HttpTransfer::store(int64_t offset, const unsigned char *data, size_t size) {
+    memcpy(_data.data() + offset, data, size);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _received += (int64_t) size;
+    while (size > 0) {
+        int64_t chunk = offset / gChunkSize;
+        int64_t count = std::min<int64_t>((int64_t) size, (chunk + 1) * gChunkSize - offset);
+        _chunkReceived[chunk] += count;
+        offset += count;
+        size -= (size_t) count;
+    }
+    _changed.notify_all();
+}
+
+// requires _mutex
+int64_t HttpTransfer::contiguousSize() const {
+    if (_totalSize < 0) {
+        return 0;
+    }
+    int count = (int) _chunkReceived.size();
+    while (_prefixChunk < count && _chunkReceived[_prefixChunk] == std::min<int64_t>(gChunkSize, _totalSize - _prefixChunk * gChunkSize)) {
+        ++_prefixChunk;
+    }
+    return _prefixChunk == count ? _totalSize.load() : _prefixChunk * gChunkSize + _chunkReceived[_prefixChunk];
+}
+
+void HttpTransfer::publish(Image image, bool complete) {
+    std::lock_guard<std::mutex> lock(_imageMutex);
+    if (_image.data) {
+        UnloadImage(_image);// never shown, the main thread was busy
+    }
+    _image = image;
+    _imageComplete = complete;
+}
+
+void HttpTransfer::saveCache() const {
+    std::string path = getHttpCachePath(_url);
+    std::string partPath = path + ".part";
+    std::error_code ec;
+    std::filesystem::create_directories(getConfigDir() + gCacheDir, ec);
+    {
+        std::ofstream out(partPath, std::ios::binary);
+        if (!out.is_open() || !out.write((const char *) _data.data(), (std::streamsize) _data.size())) {
+            return;
+        }
+    }
+    // readers never see a half written file
+    std::filesystem::rename(partPath, path, ec);
+}
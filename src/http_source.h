@@ -0,0 +1,55 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_HTTP_SOURCE_H
+#define VIEW360_HTTP_SOURCE_H
+
+#include <memory>
+#include <raylib.h>
+#include <string>
+
+// "http://" entries of the file list. Completed downloads are kept under the config directory
+// and load like local files from then on.
+
+extern bool isHttpSource(const std::string &source);
+
+// extension of the url path, without the query, e.g. ".jpg"
+extern std::string getHttpFileType(const std::string &url);
+
+extern std::string getHttpCachePath(const std::string &url);
+
+class HttpTransfer;
+
+// Fetches one url in fixed size range requests over the shared connection pool. While bytes
+// arrive, progressive jpegs are decoded up to the last complete scan, so the caller can show a
+// coarse image long before the download ends. Everything runs on background threads.
+class HttpDownload {
+public:
+    explicit HttpDownload(std::string url);
+
+    // cancels without waiting, a thread stuck resolving a slow host finishes in the background
+    ~HttpDownload();
+
+    HttpDownload(const HttpDownload &) = delete;
+
+    HttpDownload &operator=(const HttpDownload &) = delete;
+
+    // newest decoded image since the last call, the caller owns it; `complete` marks the full image
+    bool takeImage(Image &image, bool &complete);
+
+    // nothing more will arrive, either done or failed
+    bool isFinished() const;
+
+    bool isFailed() const;
+
+    float progress() const;
+
+    const std::string &url() const { return _url; }
+
+private:
+    std::string _url;
+    std::shared_ptr<HttpTransfer> _transfer;// shared with its threads, which may outlive this
+};
+
+#endif//VIEW360_HTTP_SOURCE_H
@@ -0,0 +1,56 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "image_cache.h"
+#include <cstdint>
+#include <fstream>
+
+static const uint32_t gImageMagic = 0x49523356;// "V3RI"
+
+struct RawImageHeader {
+    uint32_t magic;
+    int32_t width;
+    int32_t height;
+    int32_t format;
+};
+
+extern bool saveImageRaw(const std::string &path, const Image &image) {
+    if (!image.data || image.width <= 0 || image.height <= 0) return false;
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    RawImageHeader header{gImageMagic, image.width, image.height, image.format};
+    out.write((const char *) &header, sizeof(header));
+    out.write((const char *) image.data, GetPixelDataSize(image.width, image.height, image.format));
+    return out.good();
+}
+
+extern Image loadImageRaw(const std::string &path) {
+    Image image = {0};
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return image;
+
+    RawImageHeader header{};
+    if (!in.read((char *) &header, sizeof(header)) || header.magic != gImageMagic || header.width <= 0 || header.height <= 0) {
+        return image;
+    }
+
+    int size = GetPixelDataSize(header.width, header.height, header.format);
+    if (size <= 0) return image;
+
+    void *data = RL_MALLOC(size);
+    if (!in.read((char *) data, size)) {
+        RL_FREE(data);
+        return image;
+    }
+
+    image.data = data;
+    image.width = header.width;
+    image.height = header.height;
+    image.mipmaps = 1;
+    image.format = header.format;
+    return image;
+}
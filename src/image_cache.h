@@ -0,0 +1,18 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_IMAGE_CACHE_H
+#define VIEW360_IMAGE_CACHE_H
+
+#include <raylib.h>
+#include <string>
+
+// Uncompressed image dumps for the caches in the config directory.
+// Loading one is a single read, far faster than decoding the original file.
+extern bool saveImageRaw(const std::string &path, const Image &image);
+
+// returns an image with null data when the file is missing or invalid
+extern Image loadImageRaw(const std::string &path);
+
+#endif//VIEW360_IMAGE_CACHE_H
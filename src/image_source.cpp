@@ -0,0 +1,248 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "image_source.h"
+#include "buffer_pool.h"
+#include "http_source.h"
+#include "shm_feed.h"
+#include "zip_archive.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <new>
+
+static const char *gImageFilters = ".png;.jpg;.hdr;.bmp;.tga";
+static const char *gArchiveFilters = ".zip";
+static const char *gArchiveSeparator = "!/";
+static const size_t gHeaderReadSize = 256 * 1024;// jpeg frame headers may follow large exif blocks
+
+static std::map<std::string, std::unique_ptr<ZipArchive>> &getArchives() {
+    static std::map<std::string, std::unique_ptr<ZipArchive>> archives;
+    return archives;
+}
+
+static ZipArchive *openArchive(const std::string &path) {
+    auto &archives = getArchives();
+    auto it = archives.find(path);
+    if (it == archives.end()) {
+        it = archives.emplace(path, std::make_unique<ZipArchive>(path)).first;
+    }
+    return it->second->isOpen() ? it->second.get() : nullptr;
+}
+
+// LoadImage() would read the file into a fresh malloc block each time, the pool recycles it
+static size_t readFile(const std::string &path, PooledBuffer &buffer, size_t limit = SIZE_MAX) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return 0;
+    }
+    std::streamoff fileSize = in.tellg();
+    if (fileSize <= 0) {
+        return 0;
+    }
+    buffer.resize((size_t) std::min<unsigned long long>((unsigned long long) fileSize, limit));
+    in.seekg(0);
+    in.read((char *) buffer.data(), (std::streamsize) buffer.size());
+    return (size_t) in.gcount();
+}
+
+static Image loadImageFile(const std::string &path) {
+    Image image = {0};
+    PooledBuffer buffer;
+    size_t size = readFile(path, buffer);
+    if (size == 0 || size > INT_MAX) {
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to read file", path.c_str());
+        return image;
+    }
+    return LoadImageFromMemory(GetFileExtension(path.c_str()), buffer.data(), (int) size);
+}
+
+static bool splitArchivePath(const std::string &source, std::string &archive, std::string &entry) {
+    // the separator only counts right after an archive extension, entry names may contain it too
+    for (size_t pos = source.find(gArchiveSeparator); pos != std::string::npos; pos = source.find(gArchiveSeparator, pos + 1)) {
+        std::string candidate = source.substr(0, pos);
+        if (IsFileExtension(candidate.c_str(), gArchiveFilters)) {
+            archive = std::move(candidate);
+            entry = source.substr(pos + 2);
+            return true;
+        }
+    }
+    return false;
+}
+
+extern void appendImageSources(const char *path, std::vector<std::string> &fileList) {
+    if (isShmSource(path)) {
+        fileList.emplace_back(path);
+    } else if (isHttpSource(path)) {
+        std::string name = std::string(path).substr(0, strcspn(path, "?#"));
+        if (IsFileExtension(name.c_str(), gImageFilters)) {
+            fileList.emplace_back(path);
+        }
+    } else if (IsFileExtension(path, gArchiveFilters)) {
+        ZipArchive *archive = openArchive(path);
+        if (!archive) return;
+        for (const auto &entry: archive->entries()) {
+            if (IsFileExtension(entry.name.c_str(), gImageFilters)) {
+                fileList.push_back(std::string(path) + gArchiveSeparator + entry.name);
+            }
+        }
+    } else if (IsFileExtension(path, gImageFilters)) {
+        fileList.emplace_back(path);
+    }
+}
+
+extern bool isImageSourceAvailable(const std::string &source) {
+    if (isHttpSource(source)) {
+        return true;// checked when it is fetched
+    }
+    if (isShmSource(source)) {
+        return true;// the producer may start later
+    }
+    std::string archivePath, entryName;
+    if (!splitArchivePath(source, archivePath, entryName)) {
+        return FileExists(source.c_str());
+    }
+    ZipArchive *archive = openArchive(archivePath);
+    return archive && archive->find(entryName);
+}
+
+extern Image loadImageFromSource(const std::string &source) {
+    if (isHttpSource(source)) {
+        return loadImageFile(getHttpCachePath(source));
+    }
+    std::string archivePath, entryName;
+    if (!splitArchivePath(source, archivePath, entryName)) {
+        return loadImageFile(source);
+    }
+
+    Image image = {0};
+    ZipArchive *archive = openArchive(archivePath);
+    const ZipEntry *entry = archive ? archive->find(entryName) : nullptr;
+    if (!entry) {
+        TraceLog(LOG_WARNING, "ZIP: [%s] Entry not found", source.c_str());
+        return image;
+    }
+
+    if (entry->uncompressedSize > INT_MAX) {
+        TraceLog(LOG_WARNING, "ZIP: [%s] Entry too large, %llu bytes", source.c_str(), (unsigned long long) entry->uncompressedSize);
+        return image;
+    }
+
+    // stored entries are decoded straight from the mapping, deflated ones from `buffer`
+    PooledBuffer buffer;
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+    bool read = false;
+    try {
+        read = archive->read(*entry, buffer, data, size);
+    } catch (std::bad_alloc &) {
+        TraceLog(LOG_WARNING, "ZIP: [%s] Out of memory", source.c_str());
+        return image;
+    }
+    if (!read || size > INT_MAX) {
+        TraceLog(LOG_WARNING, "ZIP: [%s] Failed to read entry", source.c_str());
+        return image;
+    }
+
+    return LoadImageFromMemory(GetFileExtension(entryName.c_str()), data, (int) size);
+}
+
+static int readBE16(const unsigned char *p) { return (p[0] << 8) | p[1]; }
+
+static int readLE16(const unsigned char *p) { return p[0] | (p[1] << 8); }
+
+static int readBE32(const unsigned char *p) { return (int) (((unsigned) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]); }
+
+static int readLE32(const unsigned char *p) { return (int) (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned) p[3] << 24)); }
+
+// takes the file name rather than its extension, IsFileExtension() does not accept a bare ".png"
+static bool parseImageSize(const char *fileName, const unsigned char *data, size_t size, int &width, int &height) {
+    if (IsFileExtension(fileName, ".png")) {
+        if (size < 24 || memcmp(data, "\x89PNG", 4) != 0) return false;
+        width = readBE32(data + 16);
+        height = readBE32(data + 20);
+        return true;
+    }
+
+    if (IsFileExtension(fileName, ".jpg")) {
+        if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) return false;
+        size_t pos = 2;
+        while (pos + 4 <= size) {
+            if (data[pos] != 0xFF) return false;
+            unsigned char marker = data[pos + 1];
+            if (marker == 0xFF) {
+                ++pos;// fill byte
+                continue;
+            }
+            int length = readBE16(data + pos + 2);
+            // SOFn, except DHT (C4), JPG (C8) and DAC (CC)
+            bool frame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+            if (frame) {
+                if (pos + 9 > size) return false;
+                height = readBE16(data + pos + 5);
+                width = readBE16(data + pos + 7);
+                return true;
+            }
+            pos += 2 + length;
+        }
+        return false;
+    }
+
+    if (IsFileExtension(fileName, ".bmp")) {
+        if (size < 26 || data[0] != 'B' || data[1] != 'M') return false;
+        width = readLE32(data + 18);
+        height = abs(readLE32(data + 22));// negative for top-down bitmaps
+        return true;
+    }
+
+    if (IsFileExtension(fileName, ".tga")) {
+        if (size < 18) return false;
+        width = readLE16(data + 12);
+        height = readLE16(data + 14);
+        return true;
+    }
+
+    if (IsFileExtension(fileName, ".hdr")) {
+        // text header terminated by an empty line, then the resolution line: "-Y <height> +X <width>"
+        std::string header((const char *) data, std::min(size, (size_t) 4096));
+        size_t end = header.find("\n\n");
+        if (header.compare(0, 2, "#?") != 0 || end == std::string::npos) return false;
+        return sscanf(header.c_str() + end + 2, "-Y %d +X %d", &height, &width) == 2;
+    }
+
+    return false;
+}
+
+extern bool readImageSize(const std::string &source, int &width, int &height) {
+    if (isHttpSource(source)) {
+        std::string cachePath = getHttpCachePath(source);
+        return FileExists(cachePath.c_str()) && readImageSize(cachePath, width, height);
+    }
+    bool found = false;
+    std::string archivePath, entryName;
+    if (splitArchivePath(source, archivePath, entryName)) {
+        ZipArchive *archive = openArchive(archivePath);
+        const ZipEntry *entry = archive ? archive->find(entryName) : nullptr;
+        PooledBuffer buffer;
+        const unsigned char *data = nullptr;
+        size_t size = 0;
+        if (entry && archive->read(*entry, buffer, data, size, gHeaderReadSize)) {
+            found = parseImageSize(entryName.c_str(), data, size, width, height);
+        }
+    } else {
+        PooledBuffer buffer;
+        size_t size = readFile(source, buffer, gHeaderReadSize);
+        found = parseImageSize(source.c_str(), buffer.data(), size, width, height);
+    }
+    return found && width > 0 && height > 0;
+}
+
+extern void closeImageSources() {
+    getArchives().clear();
+}
@@ -0,0 +1,28 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_IMAGE_SOURCE_H
+#define VIEW360_IMAGE_SOURCE_H
+
+#include <raylib.h>
+#include <string>
+#include <vector>
+
+// Entries of the file list are either plain image files, images inside a zip archive,
+// written as "<archive path>!/<entry name>", or http urls. Archives stay mapped until closeImageSources().
+// Urls only load here once their download is cached, see HttpDownload.
+
+// Appends `path` if it is an image, or every image inside it if it is a zip archive.
+extern void appendImageSources(const char *path, std::vector<std::string> &fileList);
+
+extern bool isImageSourceAvailable(const std::string &source);
+
+extern Image loadImageFromSource(const std::string &source);
+
+// Reads the dimensions from the file header only, without decoding the image.
+extern bool readImageSize(const std::string &source, int &width, int &height);
+
+extern void closeImageSources();
+
+#endif//VIEW360_IMAGE_SOURCE_H
@@ -0,0 +1,38 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_MAPPED_FILE_H
+#define VIEW360_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are only read from disk when touched,
+// so random access into a huge file costs no more than the bytes actually used.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const { return _data != nullptr; }
+
+    const unsigned char *data() const { return _data; }
+
+    size_t size() const { return _size; }
+
+private:
+    const unsigned char *_data{nullptr};
+    size_t _size{0};
+#if defined(_WIN32)
+    void *_file{nullptr};
+    void *_mapping{nullptr};
+#endif
+};
+
+#endif//VIEW360_MAPPED_FILE_H
@@ -0,0 +1,154 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "shader_cache.h"
+#include "config.h"
+#include "gl_ext.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <rlgl.h>
+#include <string>
+#include <vector>
+
+static const char *gCacheDir = "shader_cache";
+static const uint32_t gCacheMagic = 0x42533356;// "V3SB"
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t format;
+    uint32_t length;
+};
+
+static uint64_t hashString(uint64_t hash, const char *str) {
+    // FNV-1a, the terminator is hashed too so "ab"+"c" differs from "a"+"bc"
+    do {
+        hash ^= (unsigned char) *str;
+        hash *= 1099511628211ull;
+    } while (*str++);
+    return hash;
+}
+
+static bool isProgramBinarySupported() {
+    const GLExt *gl = getGLExt();
+    if (!gl->GetIntegerv || !gl->CreateProgram || !gl->DeleteProgram || !gl->GetProgramiv || !gl->GetProgramBinary || !gl->ProgramBinary) {
+        return false;
+    }
+    int formats = 0;
+    gl->GetIntegerv(VIEW360_GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+static std::string getCachePath(const char *vsCode, const char *fsCode) {
+    // binaries are only valid for the driver that produced them
+    const GLExt *gl = getGLExt();
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashString(hash, vsCode);
+    hash = hashString(hash, fsCode);
+    for (unsigned int name: {VIEW360_GL_VENDOR, VIEW360_GL_RENDERER, VIEW360_GL_VERSION}) {
+        const char *str = gl->GetString ? (const char *) gl->GetString(name) : nullptr;
+        if (str) hash = hashString(hash, str);
+    }
+
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "%016llx.bin", (unsigned long long) hash);
+    return getConfigDir() + gCacheDir + "/" + fileName;
+}
+
+static bool loadProgramBinary(const std::string &path, unsigned int &program) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    CacheHeader header{};
+    if (!in.read((char *) &header, sizeof(header)) || header.magic != gCacheMagic || header.length == 0) {
+        return false;
+    }
+    std::vector<char> binary(header.length);
+    if (!in.read(binary.data(), (std::streamsize) binary.size())) {
+        return false;
+    }
+
+    const GLExt *gl = getGLExt();
+    unsigned int id = gl->CreateProgram();
+    gl->ProgramBinary(id, header.format, binary.data(), (int) binary.size());
+    int linked = 0;
+    gl->GetProgramiv(id, VIEW360_GL_LINK_STATUS, &linked);
+    if (!linked) {
+        gl->DeleteProgram(id);
+        return false;
+    }
+    program = id;
+    return true;
+}
+
+static void saveProgramBinary(const std::string &path, unsigned int program) {
+    const GLExt *gl = getGLExt();
+    int length = 0;
+    gl->GetProgramiv(program, VIEW360_GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    CacheHeader header{gCacheMagic, 0, 0};
+    gl->GetProgramBinary(program, length, &length, &header.format, binary.data());
+    if (length <= 0) return;
+    header.length = (uint32_t) length;
+
+    std::error_code ec;
+    std::filesystem::create_directories(getConfigDir() + gCacheDir, ec);
+
+    std::ofstream out(path, std::ios::binary);
+    if (out.is_open()) {
+        out.write((const char *) &header, sizeof(header));
+        out.write(binary.data(), length);
+    }
+}
+
+// mirrors the location setup done by LoadShaderFromMemory
+static Shader shaderFromProgram(unsigned int program) {
+    Shader shader = {0};
+    shader.id = program;
+    shader.locs = (int *) RL_CALLOC(RL_MAX_SHADER_LOCATIONS, sizeof(int));
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+
+    shader.locs[SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(program, "vertexPosition");
+    shader.locs[SHADER_LOC_VERTEX_TEXCOORD01] = rlGetLocationAttrib(program, "vertexTexCoord");
+    shader.locs[SHADER_LOC_VERTEX_TEXCOORD02] = rlGetLocationAttrib(program, "vertexTexCoord2");
+    shader.locs[SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib(program, "vertexNormal");
+    shader.locs[SHADER_LOC_VERTEX_TANGENT] = rlGetLocationAttrib(program, "vertexTangent");
+    shader.locs[SHADER_LOC_VERTEX_COLOR] = rlGetLocationAttrib(program, "vertexColor");
+
+    shader.locs[SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform(program, "mvp");
+    shader.locs[SHADER_LOC_MATRIX_VIEW] = rlGetLocationUniform(program, "matView");
+    shader.locs[SHADER_LOC_MATRIX_PROJECTION] = rlGetLocationUniform(program, "matProjection");
+    shader.locs[SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform(program, "matModel");
+    shader.locs[SHADER_LOC_MATRIX_NORMAL] = rlGetLocationUniform(program, "matNormal");
+
+    shader.locs[SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(program, "colDiffuse");
+    shader.locs[SHADER_LOC_MAP_ALBEDO] = rlGetLocationUniform(program, "texture0");
+    shader.locs[SHADER_LOC_MAP_METALNESS] = rlGetLocationUniform(program, "texture1");
+    shader.locs[SHADER_LOC_MAP_NORMAL] = rlGetLocationUniform(program, "texture2");
+
+    return shader;
+}
+
+extern Shader loadShaderCached(const char *vsCode, const char *fsCode) {
+    if (!isProgramBinarySupported()) {
+        return LoadShaderFromMemory(vsCode, fsCode);
+    }
+
+    std::string path = getCachePath(vsCode, fsCode);
+
+    unsigned int program = 0;
+    if (loadProgramBinary(path, program)) {
+        TraceLog(LOG_INFO, "SHADER: [ID %i] Program loaded from binary cache", program);
+        return shaderFromProgram(program);
+    }
+
+    Shader shader = LoadShaderFromMemory(vsCode, fsCode);
+    if (shader.id != rlGetShaderIdDefault()) {
+        saveProgramBinary(path, shader.id);
+    }
+    return shader;
+}
@@ -0,0 +1,15 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_SHADER_CACHE_H
+#define VIEW360_SHADER_CACHE_H
+
+#include <raylib.h>
+
+// Same as LoadShaderFromMemory, but keeps the linked program binary in the config directory
+// so following launches skip GLSL compilation. Falls back to plain compilation when the driver
+// does not support program binaries or the cached one is rejected (e.g. after a driver update).
+extern Shader loadShaderCached(const char *vsCode, const char *fsCode);
+
+#endif//VIEW360_SHADER_CACHE_H
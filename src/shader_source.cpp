@@ -2,6 +2,7 @@
 // Created by daiyan on 2023/5/10.
 //
 
+#include "shader_source.h"
 
 #if defined(PLATFORM_DESKTOP)// 330
 
@@ -20,17 +21,17 @@ void main() {
 const char *skybox_fs = R"(#version 330
 in vec3 fragPosition;
 uniform samplerCube environmentMap;
-uniform bool vflipped;
-uniform bool doGamma;
 out vec4 finalColor;
 void main() {
-    vec3 color = vec3(0.0);
-    if (vflipped) color = texture(environmentMap, vec3(fragPosition.x, -fragPosition.y, fragPosition.z)).rgb;
-    else color = texture(environmentMap, fragPosition).rgb;
-    if (doGamma) {
-        color = color/(color + vec3(1.0));
-        color = pow(color, vec3(1.0/2.2));
-    }
+#ifdef VFLIPPED
+    vec3 color = texture(environmentMap, vec3(fragPosition.x, -fragPosition.y, fragPosition.z)).rgb;
+#else
+    vec3 color = texture(environmentMap, fragPosition).rgb;
+#endif
+#ifdef DO_GAMMA
+    color = color/(color + vec3(1.0));
+    color = pow(color, vec3(1.0/2.2));
+#endif
     finalColor = vec4(color, 1.0);
 })";
 
@@ -60,6 +61,25 @@ void main() {
     finalColor = vec4(color, 1.0);
 })";
 
+const char *equirect_vs = R"(#version 330
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+out vec2 fragTexCoord;
+void main() {
+    fragTexCoord = vertexTexCoord;
+    gl_Position = vec4(vertexPosition, 1.0);
+})";
+
+const char *equirect_fs = R"(#version 330
+in vec2 fragTexCoord;
+uniform samplerCube environmentMap;
+out vec4 finalColor;
+void main() {
+    vec2 angle = (fragTexCoord - 0.5)*vec2(6.2832, 3.1416);
+    vec3 v = vec3(cos(angle.y)*cos(angle.x), sin(angle.y), cos(angle.y)*sin(angle.x));
+    finalColor = vec4(texture(environmentMap, v).rgb, 1.0);
+})";
+
 #else// 100
 
 const char *skybox_vs = R"(#version 100
@@ -78,17 +98,17 @@ const char *skybox_fs = R"(#version 100
 precision mediump float;
 varying vec3 fragPosition;
 uniform samplerCube environmentMap;
-uniform bool vflipped;
-uniform bool doGamma;
 void main() {
-    vec4 texelColor = vec4(0.0);
-    if (vflipped) texelColor = textureCube(environmentMap, vec3(fragPosition.x, -fragPosition.y, fragPosition.z));
-    else texelColor = textureCube(environmentMap, fragPosition);
+#ifdef VFLIPPED
+    vec4 texelColor = textureCube(environmentMap, vec3(fragPosition.x, -fragPosition.y, fragPosition.z));
+#else
+    vec4 texelColor = textureCube(environmentMap, fragPosition);
+#endif
     vec3 color = vec3(texelColor.x, texelColor.y, texelColor.z);
-    if (doGamma) {
-        color = color/(color + vec3(1.0));
-        color = pow(color, vec3(1.0/2.2));
-    }
+#ifdef DO_GAMMA
+    color = color/(color + vec3(1.0));
+    color = pow(color, vec3(1.0/2.2));
+#endif
     gl_FragColor = vec4(color, 1.0);
 })";
 
@@ -118,4 +138,34 @@ void main() {
     gl_FragColor = vec4(color, 1.0);
 })";
 
+const char *equirect_vs = R"(#version 100
+attribute vec3 vertexPosition;
+attribute vec2 vertexTexCoord;
+varying vec2 fragTexCoord;
+void main() {
+    fragTexCoord = vertexTexCoord;
+    gl_Position = vec4(vertexPosition, 1.0);
+})";
+
+const char *equirect_fs = R"(#version 100
+precision mediump float;
+varying vec2 fragTexCoord;
+uniform samplerCube environmentMap;
+void main() {
+    vec2 angle = (fragTexCoord - 0.5)*vec2(6.2832, 3.1416);
+    vec3 v = vec3(cos(angle.y)*cos(angle.x), sin(angle.y), cos(angle.y)*sin(angle.x));
+    gl_FragColor = vec4(textureCube(environmentMap, v).rgb, 1.0);
+})";
+
 #endif
+
+extern std::string skyboxFragmentShader(bool vflipped, bool doGamma) {
+    std::string defines;
+    if (vflipped) defines += "#define VFLIPPED\n";
+    if (doGamma) defines += "#define DO_GAMMA\n";
+
+    // defines must follow the #version line
+    std::string source = skybox_fs;
+    source.insert(source.find('\n') + 1, defines);
+    return source;
+}
@@ -5,10 +5,19 @@
 #ifndef VIEW360_SHADER_SOURCE_H
 #define VIEW360_SHADER_SOURCE_H
 
+#include <string>
+
 extern const char *skybox_vs;
 extern const char *skybox_fs;
 
+// skybox_fs with the flip/gamma branches resolved at compile time
+extern std::string skyboxFragmentShader(bool vflipped, bool doGamma);
+
 extern const char *cubemap_vs;
 extern const char *cubemap_fs;
 
+// renders a cubemap back to an equirectangular image, used for the session preview
+extern const char *equirect_vs;
+extern const char *equirect_fs;
+
 #endif//VIEW360_SHADER_SOURCE_H
@@ -0,0 +1,244 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "shm_feed.h"
+#include "gl_ext.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <rlgl.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char *gShmScheme = "shm://";
+static const double gAttachInterval = 1.0;// seconds between attempts while the producer is missing
+static const double gStallTimeout = 2.0;// a restarted producer creates a new segment, the old one just stops
+
+static double getClockSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int getPixelSize(uint32_t format) {
+    switch (format) {
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+            return 3;
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+extern bool isShmSource(const std::string &source) {
+    return source.compare(0, strlen(gShmScheme), gShmScheme) == 0;
+}
+
+ShmFeed::ShmFeed(const std::string &source) {
+    // POSIX names start with a single slash
+    _name = "/" + source.substr(std::min(source.size(), strlen(gShmScheme)));
+}
+
+ShmFeed::~ShmFeed() {
+    detach();
+}
+
+#if defined(_WIN32)
+
+bool ShmFeed::attach() {
+    if (!_warned) {
+        TraceLog(LOG_WARNING, "SHM: [%s] Live feeds are not supported on Windows", _name.c_str());
+        _warned = true;
+    }
+    return false;
+}
+
+void ShmFeed::detach() {}
+
+bool ShmFeed::isReplaced() const {
+    return false;
+}
+
+#else
+
+bool ShmFeed::attach() {
+    int fd = shm_open(_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        if (!_warned) {
+            TraceLog(LOG_WARNING, "SHM: [%s] No producer yet, waiting", _name.c_str());
+            _warned = true;
+        }
+        return false;
+    }
+    struct stat st {};
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t) st.st_size >= sizeof(ShmRingHeader)) {
+        mapping = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // the producer writes the magic last, a segment without it is still being set up
+    const auto *header = (const ShmRingHeader *) mapping;
+    bool ready = header->magic == VIEW360_SHM_MAGIC;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    int pixelSize = getPixelSize(header->format);
+    bool valid = ready && header->version == VIEW360_SHM_VERSION &&
+                 header->slotCount > 0 && header->width > 0 && header->height > 0 && pixelSize > 0 &&
+                 header->stride >= header->width * (uint32_t) pixelSize && header->stride % (uint32_t) pixelSize == 0 &&
+                 header->headerSize >= sizeof(ShmRingHeader) &&
+                 header->slotSize >= sizeof(ShmRingSlot) + (uint64_t) header->stride * header->height &&
+                 header->headerSize + header->slotCount * header->slotSize <= (uint64_t) st.st_size;
+    if (!valid) {
+        munmap(mapping, (size_t) st.st_size);
+        return false;
+    }
+
+    _mapping = mapping;
+    _mappingSize = (size_t) st.st_size;
+    _header = header;
+    _segmentDevice = (unsigned long long) st.st_dev;
+    _segmentInode = (unsigned long long) st.st_ino;
+    _lastSequence = 0;
+    _attachSequence = header->writeSequence.load(std::memory_order_acquire);
+    _frameTime = getClockSeconds();
+    _warned = false;
+    TraceLog(LOG_INFO, "SHM: [%s] Attached, %ux%u, format %u, %u slots", _name.c_str(), header->width, header->height, header->format, header->slotCount);
+    return true;
+}
+
+void ShmFeed::detach() {
+    if (_mapping) {
+        munmap(_mapping, _mappingSize);
+    }
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _header = nullptr;
+}
+
+bool ShmFeed::isReplaced() const {
+    int fd = shm_open(_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;// unlinked, nothing to switch to
+    }
+    struct stat st {};
+    bool replaced = fstat(fd, &st) == 0 && ((unsigned long long) st.st_dev != _segmentDevice || (unsigned long long) st.st_ino != _segmentInode);
+    close(fd);
+    return replaced;
+}
+
+#endif
+
+bool ShmFeed::update(Texture2D &texture) {
+    double now = getClockSeconds();
+    if (!_header) {
+        if (now - _attachTime < gAttachInterval) {
+            return false;
+        }
+        _attachTime = now;
+        if (!attach()) {
+            return false;
+        }
+    }
+
+    uint64_t newest = _header->writeSequence.load(std::memory_order_acquire);
+    if (newest == _lastSequence) {
+        // a paused producer may resume on the same segment, so only a new one is worth switching to
+        if (now - _frameTime > gStallTimeout && now - _attachTime >= gAttachInterval) {
+            _attachTime = now;
+            if (isReplaced()) {
+                TraceLog(LOG_INFO, "SHM: [%s] Producer restarted, re-attaching", _name.c_str());
+                detach();
+            }
+        }
+        return false;
+    }
+    if (_lastSequence > 0 && newest > _lastSequence + 1) {
+        _framesDropped += newest - _lastSequence - 1;
+    }
+    _lastSequence = newest;
+    _frameTime = now;
+
+    const ShmRingSlot *slot = getShmRingSlot(_header, (newest - 1) % _header->slotCount);
+    const uint64_t expected = 2 * (newest - 1) + 2;
+    if (slot->sequence.load(std::memory_order_acquire) != expected) {
+        _framesDropped++;// already being overwritten
+        return false;
+    }
+    uint64_t timestampNs = slot->timestampNs;
+
+    if (!upload((const unsigned char *) slot + sizeof(ShmRingSlot), texture)) {
+        return false;
+    }
+
+    // the driver has copied the pixels once TexSubImage2D returns, check they were not overwritten meanwhile,
+    // a torn frame stays in the texture only until the next one arrives
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->sequence.load(std::memory_order_relaxed) != expected) {
+        _framesDropped++;
+        return false;
+    }
+    if (newest > _attachSequence) {
+        _framesShown++;
+        _frameTimestampNs = timestampNs;
+    } else {
+        _frameTimestampNs = 0;
+    }
+    return true;
+}
+
+bool ShmFeed::upload(const unsigned char *pixels, Texture2D &texture) const {
+    const int width = (int) _header->width;
+    const int height = (int) _header->height;
+    const int format = (int) _header->format;
+    const int pixelSize = getPixelSize(_header->format);
+
+    if (!IsTextureReady(texture) || texture.width != width || texture.height != height || texture.format != format || texture.mipmaps != 1) {
+        if (IsTextureReady(texture)) {
+            UnloadTexture(texture);
+        }
+        texture = {0};
+        texture.id = rlLoadTexture(nullptr, width, height, format, 1);
+        if (texture.id == 0) {
+            return false;
+        }
+        texture.width = width;
+        texture.height = height;
+        texture.format = format;
+        texture.mipmaps = 1;
+        SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+    }
+
+    const GLExt *gl = getGLExt();
+    if (!gl->BindTexture || !gl->PixelStorei || !gl->TexSubImage2D || !gl->GetIntegerv) {
+        if ((int) _header->stride != width * pixelSize) {
+            return false;// padded rows need GL_UNPACK_ROW_LENGTH
+        }
+        UpdateTexture(texture, pixels);
+        return true;
+    }
+
+    unsigned int glInternalFormat = 0;
+    unsigned int glFormat = 0;
+    unsigned int glType = 0;
+    rlGetGlTextureFormats(format, &glInternalFormat, &glFormat, &glType);
+
+    int alignment = 4;
+    gl->GetIntegerv(VIEW360_GL_UNPACK_ALIGNMENT, &alignment);
+
+    gl->BindTexture(VIEW360_GL_TEXTURE_2D, texture.id);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ALIGNMENT, 1);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ROW_LENGTH, (int) _header->stride / pixelSize);
+    gl->TexSubImage2D(VIEW360_GL_TEXTURE_2D, 0, 0, 0, width, height, glFormat, glType, pixels);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ROW_LENGTH, 0);
+    gl->PixelStorei(VIEW360_GL_UNPACK_ALIGNMENT, alignment);
+    gl->BindTexture(VIEW360_GL_TEXTURE_2D, 0);
+    return true;
+}
@@ -0,0 +1,70 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_SHM_FEED_H
+#define VIEW360_SHM_FEED_H
+
+#include "shm_ring.h"
+#include <cstdint>
+#include <raylib.h>
+#include <string>
+
+// "shm://<name>" entries of the file list: a live feed from a POSIX shared-memory ring buffer,
+// see shm_ring.h. Not available on Windows.
+extern bool isShmSource(const std::string &source);
+
+class ShmFeed {
+public:
+    explicit ShmFeed(const std::string &source);
+
+    ~ShmFeed();
+
+    ShmFeed(const ShmFeed &) = delete;
+
+    ShmFeed &operator=(const ShmFeed &) = delete;
+
+    // Uploads the newest complete frame straight from the mapping into `texture`, recreating it
+    // when the frame size or format changes. Frames the producer wrote in between are dropped.
+    // Attaches lazily and re-attaches when the producer restarts. False when nothing was uploaded.
+    bool update(Texture2D &texture);
+
+    bool isAttached() const { return _header != nullptr; }
+
+    // steady clock time the producer stamped on the last uploaded frame, 0 when that frame was
+    // already in the ring on attach, its age says nothing about the latency
+    uint64_t frameTimestampNs() const { return _frameTimestampNs; }
+
+    // written after attaching, the frame found in the ring is shown but not counted
+    unsigned long long framesShown() const { return _framesShown; }
+
+    // skipped because a newer one was ready, or overwritten while being uploaded
+    unsigned long long framesDropped() const { return _framesDropped; }
+
+private:
+    bool attach();
+
+    void detach();
+
+    // the name now refers to a new segment, i.e. the producer was restarted
+    bool isReplaced() const;
+
+    bool upload(const unsigned char *pixels, Texture2D &texture) const;
+
+    std::string _name;
+    void *_mapping{nullptr};
+    size_t _mappingSize{0};
+    const ShmRingHeader *_header{nullptr};
+    bool _warned{false};
+    double _attachTime{-1.0e9};
+    double _frameTime{0.0};
+    uint64_t _lastSequence{0};
+    uint64_t _attachSequence{0};
+    unsigned long long _segmentDevice{0};
+    unsigned long long _segmentInode{0};
+    uint64_t _frameTimestampNs{0};
+    unsigned long long _framesShown{0};
+    unsigned long long _framesDropped{0};
+};
+
+#endif//VIEW360_SHM_FEED_H
@@ -0,0 +1,52 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_SHM_RING_H
+#define VIEW360_SHM_RING_H
+
+// Layout of the shared-memory ring buffer a live feed producer writes equirect frames into.
+// Shared with util/shm_producer, so this header must not depend on raylib.
+//
+// Frame n (counting from 0) goes to slot n % slotCount. The producer marks the slot busy by
+// setting its sequence to 2n + 1, writes the pixels, sets the sequence to 2n + 2 and finally
+// stores n + 1 in writeSequence. Readers take the newest frame and check the slot sequence
+// before and after using the pixels, a changed sequence means the producer lapped them.
+
+#include <atomic>
+#include <cstdint>
+
+#define VIEW360_SHM_MAGIC 0x46443356u// "V3DF"
+#define VIEW360_SHM_VERSION 1u
+
+struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;// raylib PixelFormat, PIXELFORMAT_UNCOMPRESSED_R8G8B8 (4) or R8G8B8A8 (7)
+    uint32_t stride;// bytes per row, a multiple of the pixel size
+    uint32_t headerSize;// offset of the first slot
+    uint64_t slotSize;// ShmRingSlot plus pixels, slot i starts at headerSize + i * slotSize
+    std::atomic<uint64_t> writeSequence;// number of completed frames
+};
+
+struct ShmRingSlot {
+    std::atomic<uint64_t> sequence;
+    uint64_t timestampNs;// steady clock of the producer when the frame was captured
+    uint64_t reserved[6];// pixels start 64 bytes into the slot
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics must be lock free");
+static_assert(sizeof(ShmRingSlot) == 64, "pixels are expected 64 bytes into a slot");
+
+inline ShmRingSlot *getShmRingSlot(ShmRingHeader *header, uint64_t index) {
+    return (ShmRingSlot *) ((unsigned char *) header + header->headerSize + index * header->slotSize);
+}
+
+inline const ShmRingSlot *getShmRingSlot(const ShmRingHeader *header, uint64_t index) {
+    return (const ShmRingSlot *) ((const unsigned char *) header + header->headerSize + index * header->slotSize);
+}
+
+#endif//VIEW360_SHM_RING_H
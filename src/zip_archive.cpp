@@ -0,0 +1,192 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#include "zip_archive.h"
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <zlib.h>
+
+static const uint32_t gEndOfCentralDirSig = 0x06054b50;
+static const uint32_t gZip64EndOfCentralDirSig = 0x06064b50;
+static const uint32_t gZip64LocatorSig = 0x07064b50;
+static const uint32_t gCentralDirHeaderSig = 0x02014b50;
+static const uint32_t gLocalHeaderSig = 0x04034b50;
+static const uint16_t gZip64ExtraId = 0x0001;
+static const uint64_t gMaxEntrySize = INT_MAX;// LoadImageFromMemory takes an int size
+static const uint64_t gMaxDeflateRatio = 1032;// the best deflate can do, larger claims are corrupt
+
+static uint16_t read16(const unsigned char *p) {
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t read32(const unsigned char *p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint64_t read64(const unsigned char *p) {
+    return (uint64_t) read32(p) | ((uint64_t) read32(p + 4) << 32);
+}
+
+ZipArchive::ZipArchive(const std::string &path) : _file(path) {
+    _open = _file.isOpen() && readCentralDirectory();
+    if (_file.isOpen() && !_open) {
+        std::cerr << "Zip: invalid archive " << path << std::endl;
+    }
+}
+
+const ZipEntry *ZipArchive::find(const std::string &name) const {
+    auto it = _index.find(name);
+    return it == _index.end() ? nullptr : &_entries[it->second];
+}
+
+bool ZipArchive::readCentralDirectory() {
+    const unsigned char *data = _file.data();
+    const size_t size = _file.size();
+    if (size < 22) return false;
+
+    // the end record is followed by a comment of at most 64 KiB
+    size_t eocd = 0;
+    bool found = false;
+    size_t lowest = size > 22 + 0xFFFF ? size - 22 - 0xFFFF : 0;
+    for (size_t pos = size - 22 + 1; pos-- > lowest;) {
+        if (read32(data + pos) == gEndOfCentralDirSig) {
+            eocd = pos;
+            found = true;
+            break;
+        }
+    }
+    if (!found) return false;
+
+    uint64_t entryCount = read16(data + eocd + 10);
+    uint64_t dirSize = read32(data + eocd + 12);
+    uint64_t dirOffset = read32(data + eocd + 16);
+
+    if (eocd >= 20 && read32(data + eocd - 20) == gZip64LocatorSig) {
+        uint64_t zip64Eocd = read64(data + eocd - 20 + 8);
+        if (zip64Eocd + 56 > size || read32(data + zip64Eocd) != gZip64EndOfCentralDirSig) return false;
+        entryCount = read64(data + zip64Eocd + 32);
+        dirSize = read64(data + zip64Eocd + 40);
+        dirOffset = read64(data + zip64Eocd + 48);
+    }
+    if (dirOffset > size || dirSize > size - dirOffset) return false;
+
+    _entries.reserve((size_t) std::min<uint64_t>(entryCount, dirSize / 46));
+
+    const unsigned char *p = data + dirOffset;
+    const unsigned char *end = p + dirSize;
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (end - p < 46 || read32(p) != gCentralDirHeaderSig) return false;
+
+        uint16_t flags = read16(p + 8);
+        uint16_t nameLength = read16(p + 28);
+        uint16_t extraLength = read16(p + 30);
+        uint16_t commentLength = read16(p + 32);
+        if (end - p < 46 + nameLength + extraLength + commentLength) return false;
+
+        ZipEntry entry;
+        entry.name.assign((const char *) p + 46, nameLength);
+        entry.method = read16(p + 10);
+        entry.compressedSize = read32(p + 20);
+        entry.uncompressedSize = read32(p + 24);
+        entry.localHeaderOffset = read32(p + 42);
+
+        // zip64 extra field, only holds the values saturated in the header, in this order
+        const unsigned char *extra = p + 46 + nameLength;
+        const unsigned char *extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4) {
+            uint16_t id = read16(extra);
+            uint16_t length = read16(extra + 2);
+            const unsigned char *field = extra + 4;
+            if (extraEnd - field < length) break;
+            if (id == gZip64ExtraId) {
+                const unsigned char *fieldEnd = field + length;
+                if (entry.uncompressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    entry.uncompressedSize = read64(field);
+                    field += 8;
+                }
+                if (entry.compressedSize == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    entry.compressedSize = read64(field);
+                    field += 8;
+                }
+                if (entry.localHeaderOffset == 0xFFFFFFFF && fieldEnd - field >= 8) {
+                    entry.localHeaderOffset = read64(field);
+                }
+            }
+            extra += 4 + length;
+        }
+
+        p += 46 + nameLength + extraLength + commentLength;
+
+        bool encrypted = flags & 0x1;
+        bool directory = !entry.name.empty() && entry.name.back() == '/';
+        bool supported = entry.method == 0 || entry.method == 8;
+        if (encrypted || directory || !supported) continue;
+
+        _index[entry.name] = _entries.size();
+        _entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+bool ZipArchive::read(const ZipEntry &entry, PooledBuffer &buffer, const unsigned char *&data, size_t &size, size_t limit) const {
+    const unsigned char *base = _file.data();
+    const size_t fileSize = _file.size();
+
+    // sizes in the local header may be zero (data descriptor), only its name/extra lengths are used
+    uint64_t offset = entry.localHeaderOffset;
+    if (offset > fileSize || fileSize - offset < 30 || read32(base + offset) != gLocalHeaderSig) return false;
+    offset += 30 + read16(base + offset + 26) + read16(base + offset + 28);
+    if (offset > fileSize || entry.compressedSize > fileSize - offset) return false;
+
+    const unsigned char *compressed = base + offset;
+
+    // checked before anything is allocated, the sizes come straight from the central directory
+    if (entry.method == 8 && entry.uncompressedSize / gMaxDeflateRatio > entry.compressedSize) return false;
+    uint64_t wanted = std::min<uint64_t>(entry.uncompressedSize, limit);
+    if (wanted > gMaxEntrySize) return false;
+
+    if (entry.method == 0) {
+        data = compressed;
+        size = (size_t) std::min<uint64_t>(entry.compressedSize, wanted);
+        return true;
+    }
+
+    buffer.resize((size_t) wanted);
+
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return false;
+
+    // zlib counts in 32 bits, so feed huge entries in slices
+    const uInt maxSlice = 1u << 30;
+    uint64_t inLeft = entry.compressedSize;
+    uint64_t outLeft = wanted;
+    stream.next_in = (Bytef *) compressed;
+    stream.next_out = buffer.data();
+
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        if (stream.avail_in == 0 && inLeft > 0) {
+            stream.avail_in = (uInt) std::min<uint64_t>(inLeft, maxSlice);
+            inLeft -= stream.avail_in;
+        }
+        if (stream.avail_out == 0 && outLeft > 0) {
+            stream.avail_out = (uInt) std::min<uint64_t>(outLeft, maxSlice);
+            outLeft -= stream.avail_out;
+        }
+        ret = inflate(&stream, Z_NO_FLUSH);
+        // out of input or output for this slice only
+        if (ret == Z_BUF_ERROR && ((stream.avail_in == 0 && inLeft > 0) || (stream.avail_out == 0 && outLeft > 0))) {
+            ret = Z_OK;
+        }
+    }
+    inflateEnd(&stream);
+
+    bool truncated = wanted < entry.uncompressedSize && stream.total_out == wanted;
+    if (ret != Z_STREAM_END && !truncated) return false;
+
+    data = buffer.data();
+    size = buffer.size();
+    return true;
+}
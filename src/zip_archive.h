@@ -0,0 +1,49 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+#ifndef VIEW360_ZIP_ARCHIVE_H
+#define VIEW360_ZIP_ARCHIVE_H
+
+#include "buffer_pool.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ZipEntry {
+    std::string name;
+    uint16_t method = 0;// 0: stored, 8: deflated
+    uint64_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
+    uint64_t localHeaderOffset = 0;
+};
+
+// Zip (and zip64) archive read through a memory mapping. Opening only parses the central
+// directory at the end of the file, reading an entry only touches that entry's bytes.
+class ZipArchive {
+public:
+    explicit ZipArchive(const std::string &path);
+
+    bool isOpen() const { return _open; }
+
+    const std::vector<ZipEntry> &entries() const { return _entries; }
+
+    const ZipEntry *find(const std::string &name) const;
+
+    // Stored entries are returned in place, pointing into the mapping, and `buffer` is left untouched.
+    // Deflated entries are inflated straight from the mapping into `buffer`.
+    // With `limit`, only the first `limit` bytes of the entry are returned.
+    bool read(const ZipEntry &entry, PooledBuffer &buffer, const unsigned char *&data, size_t &size, size_t limit = SIZE_MAX) const;
+
+private:
+    bool readCentralDirectory();
+
+    MappedFile _file;
+    bool _open{false};
+    std::vector<ZipEntry> _entries{};
+    std::unordered_map<std::string, size_t> _index{};
+};
+
+#endif//VIEW360_ZIP_ARCHIVE_H
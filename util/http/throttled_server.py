@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Static file server with Range support, keep-alive and per-connection bandwidth limits,
+standing in for the panorama server when testing the http source."""
+import argparse
+import os
+import re
+import time
+from http.server import SimpleHTTPRequestHandler, ThreadingHTTPServer
+
+
+class ThrottledHandler(SimpleHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    rate = 0  # bytes per second per connection, 0 for unlimited
+    latency = 0.0  # seconds added before every response
+    ranges = True
+
+    def do_GET(self):
+        path = self.translate_path(self.path)
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return
+        size = os.path.getsize(path)
+        first, last = 0, size - 1
+        status = 200
+        header = self.headers.get("Range") if self.ranges else None
+        if header:
+            match = re.fullmatch(r"bytes=(\d*)-(\d*)", header.strip())
+            if not match or (match.group(1) == "" and match.group(2) == ""):
+                self.send_error(416)
+                return
+            if match.group(1) == "":
+                first = max(0, size - int(match.group(2)))
+            else:
+                first = int(match.group(1))
+                if match.group(2) != "":
+                    last = min(last, int(match.group(2)))
+            if first > last:
+                self.send_response(416)
+                self.send_header("Content-Range", "bytes */%d" % size)
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+            status = 206
+
+        time.sleep(self.latency)
+        self.send_response(status)
+        self.send_header("Content-Type", self.guess_type(path))
+        self.send_header("Content-Length", str(last - first + 1))
+        self.send_header("Accept-Ranges", "bytes" if self.ranges else "none")
+        if status == 206:
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (first, last, size))
+        self.end_headers()
+
+        with open(path, "rb") as f:
+            f.seek(first)
+            self.copy_throttled(f, last - first + 1)
+
+    def copy_throttled(self, f, remaining):
+        block = 16 * 1024
+        start = time.monotonic()
+        sent = 0
+        while remaining > 0:
+            data = f.read(min(block, remaining))
+            if not data:
+                break
+            self.wfile.write(data)
+            sent += len(data)
+            remaining -= len(data)
+            if self.rate > 0:
+                delay = start + sent / self.rate - time.monotonic()
+                if delay > 0:
+                    time.sleep(delay)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("directory", nargs="?", default=".")
+    parser.add_argument("--port", type=int, default=8360)
+    parser.add_argument("--rate", type=float, default=1024, help="KiB/s per connection, 0 for unlimited")
+    parser.add_argument("--latency", type=float, default=0.05, help="seconds before each response")
+    parser.add_argument("--no-ranges", action="store_true", help="ignore Range headers, like some simple servers")
+    args = parser.parse_args()
+
+    ThrottledHandler.rate = args.rate * 1024
+    ThrottledHandler.latency = args.latency
+    ThrottledHandler.ranges = not args.no_ranges
+    os.chdir(args.directory)
+    server = ThreadingHTTPServer(("", args.port), ThrottledHandler)
+    print("serving %s on http://localhost:%d/ at %g KiB/s per connection" % (os.getcwd(), args.port, args.rate))
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,206 @@
+//
+// Created by daiyan on 2026/10/19.
+//
+
+// Test producer for the View360 live feed: writes synthetic equirect frames into a shared-memory
+// ring buffer (see src/shm_ring.h) at a fixed rate and reports its throughput.
+// Open the feed in View360 by pasting "shm://<name>".
+
+#include "shm_ring.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static const uint32_t gFormatRGB = 4;// PIXELFORMAT_UNCOMPRESSED_R8G8B8
+static const uint32_t gFormatRGBA = 7;// PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+static const uint32_t gHeaderSize = 4096;
+
+static volatile std::sig_atomic_t gStop = 0;
+
+static void onSignal(int) {
+    gStop = 1;
+}
+
+static uint64_t getClockNs() {
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static void printUsage() {
+    printf("usage: shm_producer [--name view360] [--width 4096] [--height 2048] [--fps 30] [--slots 3] [--rgb] [--frames 0]\n");
+}
+
+static float clamp01(float value) {
+    return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+}
+
+// hue by longitude, darker towards the poles, a grid line every 15 degrees
+static void drawBackground(unsigned char *pixels, uint32_t width, uint32_t height, uint32_t stride, int pixelSize) {
+    for (uint32_t y = 0; y < height; y++) {
+        unsigned char *row = pixels + (size_t) y * stride;
+        float latitude = ((float) y + 0.5f) / (float) height;
+        float shade = 0.35f + 0.65f * sinf(latitude * 3.14159265f);
+        bool latitudeLine = (y * 12) % height < 12 * 2;
+        for (uint32_t x = 0; x < width; x++) {
+            float hue = (float) x / (float) width * 6.0f;
+            float r = clamp01(fabsf(hue - 3.0f) - 1.0f);
+            float g = clamp01(2.0f - fabsf(hue - 2.0f));
+            float b = clamp01(2.0f - fabsf(hue - 4.0f));
+            bool line = latitudeLine || (x * 24) % width < 24 * 2;
+            unsigned char *p = row + (size_t) x * pixelSize;
+            p[0] = line ? 255 : (unsigned char) (r * shade * 255.0f);
+            p[1] = line ? 255 : (unsigned char) (g * shade * 255.0f);
+            p[2] = line ? 255 : (unsigned char) (b * shade * 255.0f);
+            if (pixelSize == 4) p[3] = 255;
+        }
+    }
+}
+
+// a bright band sweeping around the horizon once every 4 seconds, so dropped frames and latency are visible
+static void drawMarker(unsigned char *pixels, uint32_t width, uint32_t height, uint32_t stride, int pixelSize, uint64_t frame, double fps) {
+    const uint32_t bandWidth = std::max<uint32_t>(4, width / 256);
+    uint32_t x0 = (uint32_t) fmod((double) frame / (fps * 4.0) * width, (double) width);
+    for (uint32_t y = height / 3; y < height * 2 / 3; y++) {
+        unsigned char *row = pixels + (size_t) y * stride;
+        for (uint32_t i = 0; i < bandWidth; i++) {
+            unsigned char *p = row + (size_t) ((x0 + i) % width) * pixelSize;
+            p[0] = 255;
+            p[1] = 255;
+            p[2] = 255;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string name = "view360";
+    uint32_t width = 4096;
+    uint32_t height = 2048;
+    double fps = 30.0;
+    uint32_t slotCount = 3;
+    uint32_t format = gFormatRGBA;
+    uint64_t maxFrames = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--name" && hasValue) {
+            name = argv[++i];
+        } else if (arg == "--width" && hasValue) {
+            width = (uint32_t) strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--height" && hasValue) {
+            height = (uint32_t) strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--fps" && hasValue) {
+            fps = strtod(argv[++i], nullptr);
+        } else if (arg == "--slots" && hasValue) {
+            slotCount = (uint32_t) strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--frames" && hasValue) {
+            maxFrames = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--rgb") {
+            format = gFormatRGB;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (width == 0 || height == 0 || fps <= 0.0 || slotCount < 2) {
+        printUsage();
+        return 1;
+    }
+
+    // rows padded to 64 bytes, readers must honour the stride
+    const int pixelSize = format == gFormatRGBA ? 4 : 3;
+    const uint32_t stride = (uint32_t) alignUp((uint64_t) width * pixelSize, 64);
+    const uint64_t slotSize = alignUp(sizeof(ShmRingSlot) + (uint64_t) stride * height, 4096);
+    const uint64_t totalSize = gHeaderSize + slotCount * slotSize;
+
+    const std::string shmName = "/" + name;
+    shm_unlink(shmName.c_str());
+    int fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 || ftruncate(fd, (off_t) totalSize) != 0) {
+        perror("shm_open");
+        return 1;
+    }
+    void *mapping = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        perror("mmap");
+        shm_unlink(shmName.c_str());
+        return 1;
+    }
+
+    auto *header = (ShmRingHeader *) mapping;
+    header->version = VIEW360_SHM_VERSION;
+    header->slotCount = slotCount;
+    header->width = width;
+    header->height = height;
+    header->format = format;
+    header->stride = stride;
+    header->headerSize = gHeaderSize;
+    header->slotSize = slotSize;
+    header->writeSequence.store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < slotCount; i++) {
+        getShmRingSlot(header, i)->sequence.store(0, std::memory_order_relaxed);
+    }
+    // readers ignore the segment until the magic is in
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = VIEW360_SHM_MAGIC;
+
+    std::vector<unsigned char> background((size_t) stride * height);
+    drawBackground(background.data(), width, height, stride, pixelSize);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    printf("shm://%s: %ux%u %s, stride %u, %u slots of %.1f MB, %.1f fps\n", name.c_str(), width, height,
+           format == gFormatRGBA ? "RGBA" : "RGB", stride, slotCount, (double) slotSize / (1024.0 * 1024.0), fps);
+
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    const auto start = std::chrono::steady_clock::now();
+    auto reportTime = start;
+    uint64_t reportFrames = 0;
+    double writeSeconds = 0.0;
+    for (uint64_t frame = 0; !gStop && (maxFrames == 0 || frame < maxFrames); frame++) {
+        std::this_thread::sleep_until(start + period * (long long) frame);
+
+        ShmRingSlot *slot = getShmRingSlot(header, frame % slotCount);
+        auto *pixels = (unsigned char *) slot + sizeof(ShmRingSlot);
+        uint64_t begin = getClockNs();
+        slot->sequence.store(2 * frame + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot->timestampNs = begin;
+        memcpy(pixels, background.data(), background.size());
+        drawMarker(pixels, width, height, stride, pixelSize, frame, fps);
+        slot->sequence.store(2 * frame + 2, std::memory_order_release);
+        header->writeSequence.store(frame + 1, std::memory_order_release);
+        writeSeconds += (double) (getClockNs() - begin) * 1e-9;
+
+        reportFrames++;
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - reportTime).count();
+        if (elapsed >= 1.0) {
+            double bytes = (double) reportFrames * (double) stride * height;
+            printf("frame %llu: %.1f fps, %.0f MB/s, %.2f ms per write\n", (unsigned long long) frame + 1, (double) reportFrames / elapsed,
+                   bytes / elapsed / (1024.0 * 1024.0), writeSeconds * 1000.0 / (double) reportFrames);
+            fflush(stdout);
+            reportTime = now;
+            reportFrames = 0;
+            writeSeconds = 0.0;
+        }
+    }
+
+    munmap(mapping, totalSize);
+    shm_unlink(shmName.c_str());
+    return 0;
+}